@@ -0,0 +1,36 @@
+#include <SoftwareSerial.h>
+#include <sim900.h>
+
+SoftwareSerial shieldSerial(7, 8);
+SIM900 sim900(shieldSerial);
+
+unsigned long lastQuery = 0;
+
+void onSignal(bool success, SIM900Signal signal) {
+  if(!success) {
+    Serial.println(F("Signal query failed."));
+    return;
+  }
+
+  Serial.print(F("RSSI:\t\t"));
+  Serial.println(signal.rssi);
+
+  Serial.print(F("Bit Error Rate:\t"));
+  Serial.println(signal.bit_error_rate);
+}
+
+void setup() {
+  Serial.begin(9600);
+  shieldSerial.begin(9600);
+}
+
+void loop() {
+  sim900.poll();
+
+  if(!sim900.isBusy() && millis() - lastQuery >= 5000) {
+    lastQuery = millis();
+    sim900.signal(onSignal);
+  }
+
+  // Other work keeps running while the module answers.
+}
@@ -0,0 +1,53 @@
+#include <SoftwareSerial.h>
+#include <sim900.h>
+
+SoftwareSerial shieldSerial(7, 8);
+
+void setup() {
+  Serial.begin(9600);
+
+  shieldSerial.begin(9600);
+  SIM900 sim900(shieldSerial);
+
+  SIM900Batch batch;
+  batch.queries = SIM900_QUERY_SIGNAL |
+    SIM900_QUERY_OPERATOR |
+    SIM900_QUERY_PHONEBOOK_CAPACITY |
+    SIM900_QUERY_RTC;
+
+  if(!sim900.query(batch)) {
+    Serial.println(F("Batch query failed."));
+    return;
+  }
+
+  Serial.println(F("Health Report"));
+  Serial.println(F("-------------------"));
+
+  if(batch.received & SIM900_QUERY_SIGNAL) {
+    Serial.print(F("RSSI:\t\t"));
+    Serial.println(batch.signal.rssi);
+  }
+
+  if(batch.received & SIM900_QUERY_OPERATOR) {
+    Serial.print(F("Operator:\t"));
+    Serial.println(batch.networkOperator.name);
+  }
+
+  if(batch.received & SIM900_QUERY_PHONEBOOK_CAPACITY) {
+    Serial.print(F("Phonebook:\t"));
+    Serial.print(batch.phonebookCapacity.used);
+    Serial.print(F("/"));
+    Serial.println(batch.phonebookCapacity.max);
+  }
+
+  if(batch.received & SIM900_QUERY_RTC) {
+    Serial.print(F("Time:\t\t"));
+    Serial.print(batch.rtc.hour);
+    Serial.print(F(":"));
+    Serial.print(batch.rtc.minute);
+    Serial.print(F(":"));
+    Serial.println(batch.rtc.second);
+  }
+}
+
+void loop() { }
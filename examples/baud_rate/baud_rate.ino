@@ -0,0 +1,36 @@
+#include <SoftwareSerial.h>
+#include <sim900.h>
+
+SoftwareSerial shieldSerial(7, 8);
+
+void reopenSerial(uint32_t baud) {
+  shieldSerial.end();
+  shieldSerial.begin(baud);
+}
+
+void setup() {
+  Serial.begin(9600);
+  SIM900 sim900(shieldSerial);
+
+  uint32_t baud = sim900.detectBaudRate(reopenSerial);
+  if(baud == 0) {
+    Serial.println(F("No answer from the module."));
+    return;
+  }
+
+  Serial.print(F("Detected baud rate:\t"));
+  Serial.println(baud);
+
+  Serial.print(F("Throughput (B/s):\t"));
+  Serial.println(sim900.measureThroughput());
+
+  if(!sim900.setBaudRate(38400, reopenSerial, true)) {
+    Serial.println(F("Could not switch the baud rate."));
+    return;
+  }
+
+  Serial.print(F("Throughput (B/s):\t"));
+  Serial.println(sim900.measureThroughput());
+}
+
+void loop() { }
@@ -0,0 +1,59 @@
+#include <sim900_bank.h>
+
+SIM900 modem1(Serial1);
+SIM900 modem2(Serial2);
+SIM900 modem3(Serial3);
+
+SIM900SMS messages[6];
+
+void onJob(uint8_t modem, const SIM900BankJob& job, bool success) {
+  Serial.print(F("Modem "));
+  Serial.print(modem);
+  Serial.print(success ? F(" sent to ") : F(" failed to send to "));
+  Serial.println(job.sms->number);
+}
+
+SIM900Bank bank(onJob);
+
+void setup() {
+  Serial.begin(9600);
+
+  Serial1.begin(9600);
+  Serial2.begin(9600);
+  Serial3.begin(9600);
+
+  bank.add(modem1);
+  bank.add(modem2);
+  bank.add(modem3);
+
+  for(uint8_t i = 0; i < 6; i++) {
+    messages[i].number = F("+639XXXXXXXXX");
+    messages[i].message = F("Hello from the modem bank!");
+
+    bank.sendSMS(messages[i]);
+  }
+}
+
+void loop() {
+  bank.poll();
+
+  static unsigned long lastReport = 0;
+  if(millis() - lastReport >= 5000) {
+    lastReport = millis();
+
+    for(uint8_t i = 0; i < bank.size(); i++) {
+      SIM900BankHealth health = bank.health(i);
+
+      Serial.print(F("Modem "));
+      Serial.print(i);
+      Serial.print(F(":\t"));
+      Serial.print(health.completed);
+      Serial.print(F(" sent, "));
+      Serial.print(health.failed);
+      Serial.println(health.available ? F(" failed") : F(" failed, backing off"));
+    }
+
+    Serial.print(F("Queued:\t\t"));
+    Serial.println(bank.queued());
+  }
+}
@@ -8,6 +8,15 @@ void setup() {
 
   shieldSerial.begin(9600);
   SIM900 sim900(shieldSerial);
+
+  if(!sim900.begin(SIM900_READY_SMS, 9)) {
+    Serial.println(F("Module not ready."));
+    return;
+  }
+
+  Serial.print(F("Ready after (ms): "));
+  Serial.println(sim900.timeToReady());
+
   Serial.println(
     sim900.sendSMS("+XXxxxxxxxxxx", "Hello, world!!")
       ? "Sent!" : "Not sent."
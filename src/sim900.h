@@ -27,52 +27,921 @@
 #include <Arduino.h>
 
 #include "sim900_defs.h"
+#include "sim900_tokenizer.h"
+
+#ifndef SIM900_RX_BUFFER_SIZE
+/// Capacity in bytes of the buffer holding the response lines of a command.
+#define SIM900_RX_BUFFER_SIZE 128
+#endif
+
+#if SIM900_RX_BUFFER_SIZE < 48
+#error "SIM900_RX_BUFFER_SIZE must be at least 48 bytes."
+#endif
+
+/// Space in bytes of the response buffer kept free for the final result code.
+#define SIM900_RESULT_RESERVE 20
+
+#ifndef SIM900_HTTP_TIMEOUT
+/// Time in milliseconds to wait for an HTTP request to be sent and for each part of its response to arrive.
+#define SIM900_HTTP_TIMEOUT 30000
+#endif
+
+#ifndef SIM900_HTTP_MAX_HEADERS
+/// Maximum number of HTTP response headers kept in SIM900HTTPResponse::headers.
+#define SIM900_HTTP_MAX_HEADERS 4
+#endif
+
+#ifndef SIM900_HTTP_CHUNK_SIZE
+/// Size in bytes of the chunks in which an HTTP response body is passed to a sink callback.
+#define SIM900_HTTP_CHUNK_SIZE 32
+#endif
+
+#if SIM900_HTTP_CHUNK_SIZE < 16
+#error "SIM900_HTTP_CHUNK_SIZE must be at least 16 bytes."
+#endif
+
+#ifndef SIM900_SEND_MTU
+/// Maximum number of bytes of an HTTP request, head and body, sent with a single AT+CIPSEND.
+#define SIM900_SEND_MTU 1460
+#endif
+
+#if SIM900_SEND_MTU < SIM900_HTTP_CHUNK_SIZE || SIM900_SEND_MTU > 1460
+#error "SIM900_SEND_MTU must be between SIM900_HTTP_CHUNK_SIZE and 1460 bytes."
+#endif
+
+#ifndef SIM900_HTTP_READ_SIZE
+/// Number of response body bytes requested with each AT+HTTPREAD by the built-in HTTP engine.
+#define SIM900_HTTP_READ_SIZE 512
+#endif
+
+#if SIM900_HTTP_READ_SIZE < SIM900_HTTP_CHUNK_SIZE
+#error "SIM900_HTTP_READ_SIZE must be at least SIM900_HTTP_CHUNK_SIZE bytes."
+#endif
+
+#ifndef SIM900_MAX_CONNECTIONS
+/// Number of TCP links kept open by the connection pool. The SIM900 module supports up to 8.
+#define SIM900_MAX_CONNECTIONS 4
+#endif
+
+#if SIM900_MAX_CONNECTIONS < 1 || SIM900_MAX_CONNECTIONS > 8
+#error "SIM900_MAX_CONNECTIONS must be between 1 and 8."
+#endif
+
+#ifndef SIM900_MAX_URC_HANDLERS
+/// Maximum number of unsolicited result code handlers which can be registered at once.
+#define SIM900_MAX_URC_HANDLERS 4
+#endif
+
+#ifndef SIM900_PHONEBOOK_INDEX_SIZE
+/// Number of entries of the in-memory phonebook index, which takes 3 bytes per entry. Set to 0 to disable the index.
+#define SIM900_PHONEBOOK_INDEX_SIZE 0
+#endif
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 255
+#error "SIM900_PHONEBOOK_INDEX_SIZE must be at most 255."
+#endif
+
+#ifndef SIM900_PHONEBOOK_MATCH_DIGITS
+/// Number of trailing digits compared when looking up a phone number in the phonebook.
+#define SIM900_PHONEBOOK_MATCH_DIGITS 9
+#endif
+
+#ifdef SIM900_ENABLE_STATS
+#ifndef SIM900_STATS_FAMILIES
+/// Number of command families (e.g., +CPBR, +CIPSEND) the statistics are kept for. The last one is shared by basic commands and the families which did not fit.
+#define SIM900_STATS_FAMILIES 8
+#endif
+
+#if SIM900_STATS_FAMILIES < 1
+#error "SIM900_STATS_FAMILIES must be at least 1."
+#endif
+
+/// Number of buckets of the round-trip time histogram, split at 50, 100, 200, 500, 1000, 2000 and 5000 milliseconds.
+#define SIM900_STATS_BUCKETS 8
+#endif
+
+#ifndef SIM900_RESPONSE_TIMEOUT
+/// Default time in milliseconds to wait for a final result code of a command.
+#define SIM900_RESPONSE_TIMEOUT 2000
+#endif
+
+#ifndef SIM900_CONNECT_TIMEOUT
+/// Time in milliseconds to wait for a TCP connection to be established.
+#define SIM900_CONNECT_TIMEOUT 75000
+#endif
+
+#ifndef SIM900_GPRS_TIMEOUT
+/// Time in milliseconds to wait for the GPRS wireless connection to be brought up.
+#define SIM900_GPRS_TIMEOUT 85000
+#endif
+
+#ifndef SIM900_BOOT_TIMEOUT
+/// Default time in milliseconds to wait for the module to reach the requested readiness in begin().
+#define SIM900_BOOT_TIMEOUT 30000
+#endif
+
+#ifndef SIM900_POWER_PULSE
+/// Time in milliseconds the power key pin is held high to switch the module on.
+#define SIM900_POWER_PULSE 1200
+#endif
+
+#ifndef SIM900_SMS_TIMEOUT
+/// Time in milliseconds to wait for an SMS to be accepted by the network.
+#define SIM900_SMS_TIMEOUT 60000
+#endif
+
+#ifndef SIM900_PHONEBOOK_TIMEOUT
+/// Time in milliseconds to wait for each entry of a phonebook range read.
+#define SIM900_PHONEBOOK_TIMEOUT 10000
+#endif
 
 /**
  * 
- * @class SIM900
+ * @struct SIM900TransportIO
+ * @brief Byte-level reads from the transport of a BasicSIM900.
+ *
+ * The member functions of a concrete transport class are called directly, bypassing virtual dispatch, so they can be
+ * inlined into the receive loop. The transport must therefore be the class of the actual serial object, such as
+ * HardwareSerial, rather than a base class of it.
+ * 
+ */
+template<class Transport>
+struct SIM900TransportIO {
+    static int available(Transport& transport) {
+        return transport.Transport::available();
+    }
+
+    static int read(Transport& transport) {
+        return transport.Transport::read();
+    }
+};
+
+/// Reads from a Stream, whose concrete class is only known at run time, go through its virtual functions.
+template<>
+struct SIM900TransportIO<Stream> {
+    static int available(Stream& transport) {
+        return transport.available();
+    }
+
+    static int read(Stream& transport) {
+        return transport.read();
+    }
+};
+
+template<class Transport, uint16_t RxBufSize>
+class BasicSIM900;
+
+/// A SIM900 driver communicating through any Arduino Stream, with a receive buffer of SIM900_RX_BUFFER_SIZE bytes.
+typedef BasicSIM900<Stream, SIM900_RX_BUFFER_SIZE> SIM900;
+
+/// Callback invoked when a command submitted through SIM900::submit() completes.
+typedef void (*SIM900CommandCallback)(SIM900& sim900, SIM900CommandStatus status);
+
+/// Callback reopening the serial port connected to the module at the given baud rate.
+typedef void (*SIM900BaudCallback)(uint32_t baud);
+
+/// Callback invoked with the success flag of a non-blocking operation.
+typedef void (*SIM900ResultCallback)(bool success);
+
+/// Callback invoked with the result of a non-blocking signal quality query, zeroed if success is false.
+typedef void (*SIM900SignalCallback)(bool success, SIM900Signal signal);
+
+/// Callback invoked with the result of a non-blocking network operator query, zeroed if success is false.
+typedef void (*SIM900OperatorCallback)(bool success, SIM900Operator networkOperator);
+
+/// Callback invoked with the result of a non-blocking phonebook capacity query, zeroed if success is false.
+typedef void (*SIM900PhonebookCapacityCallback)(bool success, SIM900PhonebookCapacity capacity);
+
+/// Callback receiving the messages read from the message storage, one at a time.
+typedef void (*SIM900ReceivedSMSCallback)(SIM900ReceivedSMS sms);
+
+/// Callback receiving the entries of a phonebook range read, one at a time.
+typedef void (*SIM900PhonebookCallback)(uint8_t index, SIM900CardAccount account);
+
+/// Callback receiving the body of an HTTP response in chunks of at most SIM900_HTTP_CHUNK_SIZE bytes.
+typedef void (*SIM900HTTPBodyCallback)(const uint8_t* chunk, uint16_t length);
+
+/// Callback filling the buffer with up to size bytes of an HTTP request body, returning the number of bytes written.
+typedef uint16_t (*SIM900HTTPBodySource)(uint8_t* buffer, uint16_t size);
+
+/// Callback invoked with an unsolicited result code line received from the module.
+typedef void (*SIM900URCCallback)(const char* urc);
+
+/**
+ * 
+ * @struct SIM900URCHandler
+ * @brief A structure associating an unsolicited result code prefix with its callback.
+ * 
+ */
+typedef struct _SIM900URCHandler {
+    /// The prefix the unsolicited result code line starts with.
+    const char* prefix;
+
+    /// The callback invoked when a matching line is received.
+    SIM900URCCallback callback;
+} SIM900URCHandler;
+
+#ifdef SIM900_ENABLE_STATS
+/**
+ * 
+ * @struct SIM900CommandStats
+ * @brief A structure holding the counters of one command family.
+ *
+ * The average round-trip time is total_time / calls.
+ * 
+ */
+typedef struct _SIM900CommandStats {
+    /// The command family (e.g., "+CPBR"), or an empty string for basic commands and families which did not fit.
+    char name[8];
+
+    /// The number of round trips completed.
+    uint16_t calls;
+
+    /// The number of round trips which timed out.
+    uint16_t timeouts;
+
+    /// The number of round trips which ended with an error result code.
+    uint16_t errors;
+
+    /// The shortest round-trip time in milliseconds.
+    uint32_t min_time;
+
+    /// The longest round-trip time in milliseconds.
+    uint32_t max_time;
+
+    /// The sum of all round-trip times in milliseconds.
+    uint32_t total_time;
+
+    /// The number of bytes sent, including command lines and data written after a prompt.
+    uint32_t bytes_sent;
+
+    /// The number of bytes received, including echoes, result codes and data read after the command completed.
+    uint32_t bytes_received;
+} SIM900CommandStats;
+
+/**
+ * 
+ * @struct SIM900Stats
+ * @brief A structure holding the command statistics collected when SIM900_ENABLE_STATS is defined.
+ * 
+ */
+typedef struct _SIM900Stats {
+    /// The counters of each command family seen.
+    SIM900CommandStats families[SIM900_STATS_FAMILIES];
+
+    /// The number of command families seen.
+    uint8_t family_count;
+
+    /// The number of round trips of all families by round-trip time.
+    uint16_t histogram[SIM900_STATS_BUCKETS];
+} SIM900Stats;
+#endif
+
+/**
+ * 
+ * @class BasicSIM900
  * @brief A class for interfacing with the SIM900 GSM/GPRS module using Arduino and SoftwareSerial.
  *
  * This class provides a wide range of functionalities for working with the SIM900 module, including sending and receiving calls,
  * sending and receiving SMS, updating and extracting real-time clock data, sending HTTP requests, and retrieving various information
  * about the SIM900 module's status and the network it is connected to.
+ *
+ * The transport is bound at compile time. With a concrete serial class such as HardwareSerial, the available() and read()
+ * calls of the receive loop are made directly instead of through the Stream vtable; writes still go through Print. Most
+ * sketches use the SIM900 alias, which accepts any Stream and keeps virtual dispatch for reads as well.
+ *
+ * @tparam Transport The serial class connected to the module, providing the Stream interface.
+ * @tparam RxBufSize The size in bytes of the response buffer.
  * 
  */
-class SIM900 {
+template<class Transport, uint16_t RxBufSize>
+class BasicSIM900 {
+    static_assert(RxBufSize >= 48, "RxBufSize must be at least 48 bytes.");
+
+public:
+    /// Callback invoked when a command submitted through submit() completes, SIM900CommandCallback for the SIM900 alias.
+    typedef void (*CommandCallback)(BasicSIM900& sim900, SIM900CommandStatus status);
+
 private:
-    /// The SoftwareSerial object used for communication with the SIM900 module.
-    Stream& sim900;
+    /// The serial port used for communication with the SIM900 module.
+    Transport& sim900;
 
     /// A flag indicating whether Access Point Name (APN) configuration is set.
     bool hasAPN = false;
 
-    /// Send a command to the SIM900 module.
+    /// The Access Point Name (APN) configuration, kept for the bearer of the built-in HTTP engine.
+    SIM900APN apn;
+
+    /// A flag indicating whether the bearer profile of the built-in HTTP engine is open.
+    bool bearerOpen = false;
+
+    /// The backend used to carry HTTP requests.
+    SIM900HTTPEngine httpEngine = SIM900_HTTP_ENGINE_TCP;
+
+    /// A flag indicating whether multiple TCP connections (AT+CIPMUX=1) are enabled.
+    bool multiConnection = false;
+
+    /// The message format last set on the module (AT+CMGF), or -1 if unknown.
+    int8_t messageFormat = -1;
+
+    /// The SIM900Readiness flags of the boot stages the module has reached.
+    uint8_t readyFlags = 0;
+
+    /// The time in milliseconds begin() took to reach the requested readiness.
+    uint32_t readyTime = 0;
+
+    /// The engineering mode last set on the module (AT+CENG), or -1 if unknown.
+    int8_t engineeringMode = -1;
+
+    /// The command echo mode last set on the module (ATE), or -1 if unknown.
+    int8_t echoMode = -1;
+
+    /// The TCP links of the connection pool.
+    SIM900Connection connections[SIM900_MAX_CONNECTIONS];
+
+    /// The link whose received data is being read, or -1 when reading the stream directly.
+    int8_t activeLink = -1;
+
+    /// The number of bytes left in the received data frame of the active link.
+    uint16_t frameRemaining = 0;
+
+    /// The stream the body of the current HTTP request is read from, if any.
+    Stream* uploadStream = NULL;
+
+    /// The callback the body of the current HTTP request is read from, if any.
+    SIM900HTTPBodySource uploadSource = NULL;
+
+    /// The length of the streamed body of the current HTTP request.
+    uint32_t uploadLength = 0;
+
+    /// Get the number of bytes waiting on the transport.
+    int transportAvailable() {
+        return SIM900TransportIO<Transport>::available(this->sim900);
+    }
+
+    /// Read a byte from the transport, returning -1 if none is waiting.
+    int transportRead() {
+        return SIM900TransportIO<Transport>::read(this->sim900);
+    }
+
+    /// Handler run by the command engine when the pending command completes.
+    typedef void (BasicSIM900::*Completion)(SIM900CommandStatus status);
+
+    /// Handler run by the command engine for each information line of the pending command.
+    typedef void (BasicSIM900::*LineHandler)(char* line);
+
+    /// The handler consuming the information lines of the pending command instead of keeping them in the response buffer.
+    LineHandler lineHandler = NULL;
+
+    /// The message being assembled from the listing of the message storage.
+    SIM900ReceivedSMS receivedSMS;
+
+    /// A flag indicating whether a message is being assembled from the listing of the message storage.
+    bool receivedPending = false;
+
+    /// The number of records delivered by the line handler of the pending command.
+    uint16_t deliveredCount = 0;
+
+    /// The array receiving the entries of a phonebook range read, or NULL if they go to the callback.
+    SIM900CardAccount* pendingAccounts = NULL;
+
+    /// The index of the first entry of the phonebook range read.
+    uint8_t pendingFirst = 0;
+
+    /// The number of entries the array of the phonebook range read can hold.
+    uint8_t pendingSize = 0;
+
+    /// The bitmaps of occupied and up-to-date entries filled in while syncing the phonebook, or NULL.
+    uint8_t* pendingBitmap = NULL;
+
+    /// The phone number looked up by a phonebook scan.
+    const char* pendingNumber = NULL;
+
+    /// The index of the entry matching the phone number looked up by a phonebook scan, or -1.
+    int16_t pendingMatch = -1;
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    /// The hashes of the phone numbers in the phonebook index.
+    uint16_t indexHashes[SIM900_PHONEBOOK_INDEX_SIZE];
+
+    /// The phonebook entries of the phone numbers in the phonebook index.
+    uint8_t indexEntries[SIM900_PHONEBOOK_INDEX_SIZE];
+
+    /// The number of phone numbers in the phonebook index.
+    uint8_t indexCount = 0;
+
+    /// A flag indicating whether the phonebook index was built and holds every entry of the phonebook.
+    bool indexBuilt = false;
+#endif
+
+    /// The number of bytes received from the module, by the command engine or read directly from the stream.
+    uint32_t bytesReceived = 0;
+
+#ifdef SIM900_ENABLE_STATS
+    /// The command statistics collected so far.
+    SIM900Stats statistics;
+
+    /// The index of the statistics family of the pending command.
+    uint8_t statsFamily = 0;
+
+    /// The time in milliseconds at which the pending round trip started.
+    uint32_t statsStart = 0;
+
+    /// The number of bytes received before the pending round trip started.
+    uint32_t statsReceived = 0;
+#endif
+
+    /// The state of the command currently processed by the command engine.
+    SIM900CommandStatus commandStatus = SIM900_COMMAND_IDLE;
+
+    /// The time in milliseconds at which the pending command was sent.
+    uint32_t commandStart = 0;
+
+    /// The deadline in milliseconds of the pending command.
+    uint32_t commandTimeout = SIM900_RESPONSE_TIMEOUT;
+
+    /// The response lines received so far for the pending command, separated by '\n' and null-terminated.
+    char responseBuffer[RxBufSize];
+
+    /// The number of bytes stored in the response buffer.
+    uint16_t responseLength = 0;
+
+    /// The offset in the response buffer of the line currently being received.
+    uint16_t lineStart = 0;
+
+    /// The offset in the response buffer of the final result code of the last command.
+    uint16_t resultStart = 0;
+
+    /// A flag indicating whether the buffer still holds the response of the last completed command.
+    bool responseHeld = false;
+
+    /// A flag indicating whether the command echo may still arrive.
+    bool echoPending = false;
+
+    /// The name of the pending extended command (e.g., "+CPIN"), whose own result lines are never treated as unsolicited.
+    char commandName[8];
+
+    /// A flag indicating whether the line being received continues a two-line unsolicited result code.
+    bool urcContinued = false;
+
+    /// A flag indicating whether the lines being received are message text, passed to the line handler even if they look like result codes. It is cleared by a line following an empty one, such as the final result code.
+    bool textPending = false;
+
+    /// A flag indicating whether the last line received was empty.
+    bool lineBlank = false;
+
+    /// A flag indicating whether the pending command (AT+CMGS, AT+CIPSEND) is answered with a '>' prompt.
+    bool promptExpected = false;
+
+    /// A flag indicating whether the pending command (AT+CIFSR) is answered with a bare IP address instead of a result code.
+    bool addressExpected = false;
+
+    /// The offset in the response buffer of the two-line unsolicited result code being received.
+    uint16_t urcStart = 0;
+
+    /// The registered unsolicited result code handlers.
+    SIM900URCHandler urcHandlers[SIM900_MAX_URC_HANDLERS];
+
+    /// The headers of the last HTTP response.
+    SIM900HTTPHeader httpHeaders[SIM900_HTTP_MAX_HEADERS];
+
+    /// Data to be written once the module shows the '>' prompt.
+    String pendingPayload;
+
+    /// The message reference (+CMGS) of the last SMS sent without blocking, or -1 if none was reported.
+    int16_t sentReference = -1;
+
+    /// The batch whose results are being received.
+    SIM900Batch* pendingBatch = NULL;
+
+    /// The handler to run when the pending command completes.
+    Completion completion = NULL;
+
+    /// The user callback of the pending non-blocking operation.
+    union {
+        CommandCallback command;
+        SIM900ResultCallback result;
+        SIM900SignalCallback signal;
+        SIM900OperatorCallback networkOperator;
+        SIM900PhonebookCapacityCallback phonebookCapacity;
+        SIM900ReceivedSMSCallback receivedSMS;
+        SIM900PhonebookCallback phonebook;
+    } callback;
+
+    /// Send a command to the SIM900 module, waiting for any pending command to complete first.
     void sendCommand(String message);
 
+    /// Send a command printed from a flash-resident prefix and its parameters, without assembling it in RAM.
+    template<typename... Pieces>
+    void sendCommand(const __FlashStringHelper* prefix, const Pieces&... pieces) {
+        this->await();
+        this->startCommand(NULL, SIM900_RESPONSE_TIMEOUT, prefix, pieces...);
+    }
+
+    /// Start a command printed from a flash-resident prefix and its parameters, registering the handler to run when it completes.
+    template<typename... Pieces>
+    bool startCommand(Completion handler, uint32_t timeout, const __FlashStringHelper* prefix, const Pieces&... pieces) {
+        if(this->isBusy())
+            return false;
+
+        this->nameCommand(reinterpret_cast<const char*>(prefix), true);
+        this->armCommand(handler, timeout);
+
+        size_t length = this->sim900.print(prefix);
+        length += this->printPieces(pieces...);
+        length += this->sim900.println();
+
+        this->countSent(length);
+        return true;
+    }
+
+    /// Print the parameters of a command, returning the number of bytes written.
+    template<typename Piece, typename... Pieces>
+    size_t printPieces(const Piece& piece, const Pieces&... pieces) {
+        size_t length = this->sim900.print(piece);
+        return length + this->printPieces(pieces...);
+    }
+
+    /// End of the parameters of a command.
+    size_t printPieces() {
+        return 0;
+    }
+
+    /// Start a command and register the handler to run when it completes.
+    bool startCommand(String message, Completion handler, uint32_t timeout = SIM900_RESPONSE_TIMEOUT);
+
+    /// Extract the extended command name from a command in RAM or, if flash is set, in flash memory.
+    void nameCommand(const char* message, bool flash);
+
+    /// Account the bytes of a sent command in the statistics, if enabled.
+    void countSent(size_t length);
+
+    /// Reset the response state and wait for a new final result code.
+    void armCommand(Completion handler, uint32_t timeout);
+
+    /// Mark the pending command as completed and run its completion handler.
+    void finishCommand(SIM900CommandStatus status);
+
+    /// Block until the pending command completes.
+    void await();
+
+    /// Feed one received byte into the response buffer, returning the resulting command status.
+    SIM900CommandStatus receive(char ch);
+
+    /// Process a completed, null-terminated response line, returning the resulting command status.
+    SIM900CommandStatus receiveLine(char* line);
+
+    /// Discard the response line currently being received.
+    void dropLine();
+
+    /// Check if a response line is an unsolicited result code.
+    bool isURC(const char* line);
+
+    /// Check if a response line is a bare dotted-quad IP address.
+    bool isAddress(const char* line);
+
+    /// Pass an unsolicited result code to the handlers registered for its prefix.
+    void dispatchURC(const char* urc);
+
     /// Check if the last command was successful.
-    bool isSuccessCommand();
+    bool isSuccessCommand(uint32_t timeout = SIM900_RESPONSE_TIMEOUT);
+
+    /// Classify a response line as a final result code, returning SIM900_COMMAND_PENDING for intermediate lines.
+    SIM900CommandStatus finalResult(const char* line);
+
+    /// Find a response line in the result code table, returning its index or -1 if it is not a final result code.
+    int8_t findResultCode(const char* line);
+
+    /// Map the final result code of the last dial command to a SIM900DialResult.
+    SIM900DialResult dialResult();
+
+    /// Completion handler invoking a SIM900CommandCallback.
+    void completeCommand(SIM900CommandStatus status);
+
+    /// Completion handler invoking a SIM900ResultCallback.
+    void completeResult(SIM900CommandStatus status);
+
+    /// Completion handler invoking a SIM900SignalCallback.
+    void completeSignal(SIM900CommandStatus status);
+
+    /// Completion handler invoking a SIM900OperatorCallback.
+    void completeOperator(SIM900CommandStatus status);
+
+    /// Completion handler invoking a SIM900PhonebookCapacityCallback.
+    void completePhonebookCapacity(SIM900CommandStatus status);
+
+    /// Completion handler filling in the results of a batch.
+    void completeBatch(SIM900CommandStatus status);
+
+    /// Set a module setting unless its shadow copy shows it is already set, e.g. applySetting(messageFormat, 1, F("AT+CMGF=")).
+    bool applySetting(int8_t& shadow, int8_t value, const __FlashStringHelper* command);
+
+#ifdef SIM900_ENABLE_STATS
+    /// Find or add the statistics family of a command name.
+    uint8_t statsFamilyOf(const char* name);
+
+    /// Record a completed round trip in the statistics of the pending command family.
+    void recordStats(SIM900CommandStatus status);
+#endif
+
+    /// Mark a boot stage, and the stages before it, as reached.
+    void markReady(uint8_t stage);
+
+    /// Query the module for the boot stages whose unsolicited result codes were missed.
+    void probeReadiness();
+
+    /// Forget the shadow copies of the module settings, after the module was reset.
+    void invalidateSettings();
+
+    /// Send one message of an SMS batch, with text mode already set.
+    bool sendBatchSMS(SIM900SMS& sms);
+
+    /// Completion handler sending the SMS recipient once text mode is set.
+    void completeSMSFormat(SIM900CommandStatus status);
+
+    /// Completion handler writing the SMS text once the '>' prompt is shown.
+    void completeSMSPrompt(SIM900CommandStatus status);
 
-    /// Get the response from the SIM900 module.
-    String getResponse();
+    /// Line handler dropping the echo of the SMS text and keeping the message reference (+CMGS).
+    void receiveSMSSentLine(char* line);
+
+    /// Line handler assembling messages from the listing of the message storage (AT+CMGL).
+    void receiveSMSListLine(char* line);
+
+    /// Completion handler delivering the last message of the listing of the message storage.
+    void completeSMSList(SIM900CommandStatus status);
+
+    /// Pass the assembled message to the callback, if one is being assembled.
+    void deliverReceivedSMS();
+
+    /// Read a range of phonebook entries, passing them to the pending callback or array.
+    SIM900PhonebookReport readPhonebookRange(uint8_t first, uint8_t last);
+
+    /// Line handler passing each entry of a phonebook range read (AT+CPBR) to the callback or array.
+    void receivePhonebookLine(char* line);
+
+    /// Line handler recording which entries are occupied and which already match the desired contacts of a phonebook sync.
+    void receivePhonebookSyncLine(char* line);
+
+    /// Line handler recording the first entry whose phone number matches the one looked up by a phonebook scan.
+    void receivePhonebookMatchLine(char* line);
+
+    /// Hash the trailing SIM900_PHONEBOOK_MATCH_DIGITS digits of a phone number.
+    uint16_t hashNumber(const char* number);
+
+    /// Compare the trailing SIM900_PHONEBOOK_MATCH_DIGITS digits of two phone numbers.
+    bool matchNumber(const char* first, const char* second);
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    /// Line handler adding each entry of a phonebook range read to the phonebook index.
+    void receivePhonebookIndexLine(char* line);
+
+    /// Add or replace the phone number of a phonebook entry in the phonebook index.
+    void indexPhonebook(uint8_t index, const char* number);
+
+    /// Remove a phonebook entry from the phonebook index.
+    void unindexPhonebook(uint8_t index);
+#endif
+
+    /// Parse a phonebook entry query result, storing the index of the entry.
+    SIM900CardAccount parsePhonebookEntry(char* result, uint8_t& index);
+
+    /// Parse a signal quality query result.
+    SIM900Signal parseSignal(char* result);
+
+    /// Parse a network operator query result.
+    SIM900Operator parseOperator(char* result);
+
+    /// Parse a phonebook capacity query result.
+    SIM900PhonebookCapacity parsePhonebookCapacity(char* result);
+
+    /// Parse a real-time clock query result.
+    SIM900RTC parseRtc(char* result);
+
+    /// Parse an unquoted timestamp (e.g., 24/01/01,10:00:00+32).
+    SIM900RTC parseTimestamp(char* time);
+
+    /// Get the response from the SIM900 module, returning as soon as a final result code arrives or the timeout elapses.
+    char* getResponse(uint32_t timeout = SIM900_RESPONSE_TIMEOUT);
+
+    /// Read one byte directly from the stream, waiting up to the timeout for it to arrive. Returns -1 on timeout.
+    int readStream(uint32_t timeout);
+
+    /// Read one byte of data received on the active link, or from the stream if there is none. Returns -1 on timeout or when the link was closed.
+    int readRaw(uint32_t timeout);
+
+    /// Skip the link number prefix (e.g., "0, ") of a result line reported in multi-connection mode.
+    const char* stripLink(const char* line);
+
+    /// Update the state of the connection pool from an unsolicited result code.
+    void trackURC(const char* urc);
+
+    /// Open a TCP connection, or reuse a pooled one to the same server, returning its link or -1 on failure.
+    int8_t openConnection(const char* domain, uint16_t port, bool& reused);
+
+    /// Close a TCP connection.
+    void closeConnection(int8_t link);
+
+    /// Read one line directly from the stream into the response buffer, without its line terminator.
+    bool readRawLine(uint32_t timeout);
+
+    /// Print the head and body of an HTTP request, returning the number of bytes printed.
+    size_t printHTTPRequest(Print& out, const SIM900HTTPRequest& request, bool keepAlive);
+
+    /// Send an HTTP request over an open TCP connection, in chunks of at most SIM900_SEND_MTU bytes.
+    bool sendHTTPRequest(int8_t link, const SIM900HTTPRequest& request);
+
+    /// Start sending data of the given length over an open TCP connection, waiting for the prompt.
+    bool beginSend(int8_t link, uint16_t length);
+
+    /// Wait until the data of the current AT+CIPSEND is acknowledged.
+    bool endSend();
+
+    /// Write the next bytes of the streamed request body, padding with zeros if the source runs out early.
+    bool writeUpload(uint16_t length);
+
+    /// Receive and parse an HTTP response from an open TCP connection, returning false if the connection cannot be reused.
+    bool receiveHTTPResponse(int8_t link, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink);
+
+    /// Parse the status line, headers and body of an HTTP response, clearing keepAlive if the connection cannot be reused.
+    bool parseHTTPResponse(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, bool& keepAlive);
+
+    /// Open the GPRS bearer profile used by the built-in HTTP engine (AT+SAPBR).
+    bool openBearer();
+
+    /// Set a parameter of the built-in HTTP engine (AT+HTTPPARA) to the concatenation of the given pieces.
+    template<typename... Pieces>
+    bool setHTTPParameter(const __FlashStringHelper* name, const Pieces&... value) {
+        this->sendCommand(F("AT+HTTPPARA=\""), name, F("\",\""), value..., '"');
+        return this->isSuccessCommand();
+    }
+
+    /// Carry out an HTTP request with the built-in HTTP engine of the module.
+    bool builtinHTTPRequest(const SIM900HTTPRequest& request, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink);
+
+    /// Read one window of the response body held by the built-in HTTP engine (AT+HTTPREAD), returning the number of bytes read or -1 on failure.
+    int32_t readHTTPWindow(uint32_t offset, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink);
+
+    /// Receive an HTTP response body of a known length, or until the connection is closed if the length is negative.
+    bool receiveHTTPBody(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, int32_t length);
+
+    /// Pass a chunk of an HTTP response body to the sink callback, or append it to the response data if there is none.
+    void deliverHTTPBody(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, const uint8_t* chunk, uint16_t length);
 
     /// Get the returned operational mode from the SIM900 module.
-    String getReturnedMode();
+    const char* getReturnedMode(uint32_t timeout = SIM900_RESPONSE_TIMEOUT);
 
     /// Perform a raw query operation on a specified line.
-    String rawQueryOnLine(uint16_t line);
+    char* rawQueryOnLine(uint16_t line);
 
     /// Retrieve the result of a query operation.
-    String queryResult();
+    char* queryResult();
+
+    /// Extract the result of a query operation from a response, returning NULL if there is none.
+    char* queryResult(char* response);
 
 public:
     /**
      * 
      * @brief Constructor for the SIM900 class.
      *
-     * @param _sim900 A pointer to the SoftwareSerial object for communication with the SIM900 module.
+     * @param _sim900 A reference to the serial port used for communication with the SIM900 module.
+     * 
+     */
+    BasicSIM900(Transport& _sim900);
+
+    /**
+     * 
+     * @brief Submit a command without waiting for its response.
+     *
+     * The command is written to the module immediately and its response is collected by subsequent calls to poll().
+     * Only one command can be in flight at a time.
+     *
+     * @param command The AT command to send.
+     * @param callback An optional callback invoked from poll() once the command completes.
+     * @param timeout The time in milliseconds to wait for a final result code.
+     * @return True if the command was submitted, false if another command is still pending.
+     * 
+     */
+    bool submit(String command, CommandCallback callback = NULL, uint32_t timeout = SIM900_RESPONSE_TIMEOUT);
+
+    /**
+     * 
+     * @brief Advance the command engine using the bytes available on the stream.
+     *
+     * This function never blocks and should be called repeatedly from loop(), both while a non-blocking operation
+     * is pending and to receive unsolicited result codes while idle. Completion and unsolicited result code
+     * callbacks are invoked from within this function.
+     *
+     * @return True if the pending command completed during this call, false otherwise.
+     * 
+     */
+    bool poll();
+
+    /**
+     * 
+     * @brief Register a handler for unsolicited result codes.
+     *
+     * Unsolicited result codes (e.g., RING, +CLIP, +CMTI, +CMT, CLOSED, +PDP: DEACT, Call Ready, UNDER-VOLTAGE) are
+     * removed from command responses wherever they arrive and passed to the handler whose prefix they start with.
+     * Handlers run from poll() and from the blocking methods while they wait for a response. For +CMT, the header
+     * line and the message text are passed together, separated by '\n'.
+     *
+     * @param prefix The prefix to match, such as "+CMTI:". It is not copied and must remain valid.
+     * @param callback The callback to invoke, or NULL to remove the handler registered for the prefix.
+     * @return True if the handler was registered or removed, false if all handler slots are in use.
+     * 
+     */
+    bool onURC(const char* prefix, SIM900URCCallback callback);
+
+    /**
+     * 
+     * @brief Check if a command is still waiting for its final result code.
+     *
+     * @return True if a command is pending, false otherwise.
+     * 
+     */
+    bool isBusy();
+
+    /**
+     * 
+     * @brief Get the state of the most recent command.
+     *
+     * @return The status of the most recent command, as a SIM900CommandStatus.
      * 
      */
-    SIM900(Stream& _sim900);
+    SIM900CommandStatus status();
+
+    /**
+     * 
+     * @brief Get the response received for the most recent command.
+     *
+     * The response lines are separated by '\n' and exclude the command echo and unsolicited result codes. The
+     * returned buffer is owned by this object and is only valid until the next command is submitted or poll()
+     * receives unsolicited data.
+     *
+     * @return The response, including the final result code.
+     * 
+     */
+    char* lastResponse();
+
+    /**
+     * 
+     * @brief Wait for the SIM900 module to boot, switching it on first if needed.
+     *
+     * The boot stages are tracked from the unsolicited result codes the module sends while starting up (RDY, +CFUN: 1,
+     * +CPIN: READY, Call Ready, SMS Ready), and begin() returns as soon as the requested stages are reached. Whenever
+     * the module stays silent, the stages are queried instead, so begin() also returns quickly if the module was
+     * already running.
+     *
+     * @param readiness The SIM900Readiness flags of the boot stages to wait for.
+     * @param powerPin The pin driving the power key of the module, or -1. If the module does not answer, the pin is
+     * held high for SIM900_POWER_PULSE milliseconds to switch it on.
+     * @param timeout The time in milliseconds to wait for the requested stages.
+     * @return True if the requested stages were reached, false on timeout.
+     * 
+     */
+    bool begin(uint8_t readiness = SIM900_READY_SMS, int8_t powerPin = -1, uint32_t timeout = SIM900_BOOT_TIMEOUT);
+
+    /**
+     * 
+     * @brief Get the boot stages the module has reached.
+     *
+     * @return The SIM900Readiness flags of the reached boot stages.
+     * 
+     */
+    uint8_t readiness();
+
+    /**
+     * 
+     * @brief Get the time the last successful begin() took until the module was ready.
+     *
+     * @return The time in milliseconds, including switching the module on.
+     * 
+     */
+    uint32_t timeToReady();
+
+#ifdef SIM900_ENABLE_STATS
+    /**
+     * 
+     * @brief Copy the command statistics collected so far.
+     *
+     * Only available when SIM900_ENABLE_STATS is defined.
+     *
+     * @param snapshot The structure receiving the statistics.
+     * 
+     */
+    void statsSnapshot(SIM900Stats& snapshot);
+
+    /**
+     * 
+     * @brief Clear the command statistics.
+     *
+     * Only available when SIM900_ENABLE_STATS is defined.
+     * 
+     */
+    void resetStats();
+#endif
 
     /**
      * 
@@ -83,6 +952,66 @@ public:
      */
     bool handshake();
 
+    /**
+     * 
+     * @brief Enable or disable the echo of commands by the module (ATE).
+     *
+     * Disabling the echo halves the bytes received for every command. Responses are parsed the same either way.
+     *
+     * @param enabled True to echo commands, false otherwise.
+     * @return True if the echo mode was set, false otherwise.
+     * 
+     */
+    bool setEcho(bool enabled);
+
+    /**
+     * 
+     * @brief Detect the baud rate the module is using by probing the common rates with a handshake.
+     *
+     * @param reopen The callback reopening the serial port at each probed baud rate, e.g. by calling begin().
+     * @return The detected baud rate with the serial port left open at it, or 0 if the module answered at no rate.
+     * 
+     */
+    uint32_t detectBaudRate(SIM900BaudCallback reopen);
+
+    /**
+     * 
+     * @brief Switch the module and the serial port to another baud rate (AT+IPR).
+     *
+     * The serial port is reopened at the new rate with the callback, and the module is checked to answer at it.
+     * SoftwareSerial is not reliable above 57600 baud, so hardware serial ports should be used for higher rates.
+     *
+     * @param baud The new baud rate, such as 57600 or 115200.
+     * @param reopen The callback reopening the serial port at the new baud rate.
+     * @param persist True to save the baud rate in the module's profile (AT&W) so it is kept after a restart.
+     * @return True if the module answers at the new baud rate, false otherwise.
+     * 
+     */
+    bool setBaudRate(uint32_t baud, SIM900BaudCallback reopen, bool persist = false);
+
+    /**
+     * 
+     * @brief Measure the effective throughput of the serial link to the module.
+     *
+     * A short identification query (ATI) is repeated and the bytes sent and received are timed, so the result includes
+     * the latency of the module as well as the line rate.
+     *
+     * @param rounds The number of queries to time.
+     * @return The measured throughput in bytes per second, or 0 if the module did not answer.
+     * 
+     */
+    uint32_t measureThroughput(uint8_t rounds = 8);
+
+    /**
+     * 
+     * @brief Perform a handshake without blocking.
+     *
+     * @param callback The callback invoked from poll() with the outcome of the handshake.
+     * @return True if the command was submitted, false if another command is still pending.
+     * 
+     */
+    bool handshake(SIM900ResultCallback callback);
+
     /**
      * 
      * @brief Close the communication with the SIM900 module.
@@ -118,6 +1047,16 @@ public:
      */
     SIM900Signal signal();
 
+    /**
+     * 
+     * @brief Query the signal strength and bit error rate without blocking.
+     *
+     * @param callback The callback invoked from poll() with the success flag and the signal quality.
+     * @return True if the command was submitted, false if another command is still pending.
+     * 
+     */
+    bool signal(SIM900SignalCallback callback);
+
     /**
      * 
      * @brief Initiate an outgoing call to a phone number.
@@ -174,6 +1113,67 @@ public:
      */
     bool sendSMS(String number, String message);
 
+    /**
+     * 
+     * @brief Send an SMS (Short Message Service) without blocking.
+     *
+     * @param number The recipient's phone number.
+     * @param message The SMS message content.
+     * @param callback The callback invoked from poll() once the network accepted or rejected the message.
+     * @return True if the operation was started, false if another command is still pending.
+     * 
+     */
+    bool sendSMS(String number, String message, SIM900ResultCallback callback);
+
+    /**
+     * 
+     * @brief Get the message reference of the last SMS sent without blocking.
+     *
+     * @return The reference reported by the network (+CMGS), or -1 if the message was not accepted.
+     * 
+     */
+    int16_t smsReference();
+
+    /**
+     * 
+     * @brief Send a batch of SMS messages.
+     *
+     * Text mode is set once for the whole batch, and each message is written as soon as the module shows its
+     * '>' prompt. The sent and reference fields of every message are filled in with its outcome.
+     *
+     * @param messages The array of messages to send.
+     * @param count The number of messages in the array.
+     * @return A SIM900SMSReport structure with the number of sent and failed messages and the throughput of the batch.
+     * 
+     */
+    SIM900SMSReport sendSMS(SIM900SMS* messages, uint16_t count);
+
+    /**
+     * 
+     * @brief Read the messages in the message storage.
+     *
+     * The storage is listed with a single AT+CMGL command whose response is parsed as it arrives, so only one message
+     * is held in memory at a time. Each line of a message text is limited to SIM900_RX_BUFFER_SIZE - 1 characters.
+     * Listed messages are marked as read by the module.
+     *
+     * @param callback The callback receiving each message.
+     * @param unreadOnly True to list only unread messages, false to list all messages.
+     * @param drain True to delete all read messages (AT+CMGDA) once the listing is complete.
+     * @return The number of messages read, or -1 if the listing or the deletion failed.
+     * 
+     */
+    int16_t readSMS(SIM900ReceivedSMSCallback callback, bool unreadOnly = false, bool drain = false);
+
+    /**
+     * 
+     * @brief Delete messages from the message storage in one command (AT+CMGDA).
+     *
+     * @param readOnly True to delete only the messages which were read, false to delete all messages.
+     * @return True if the messages were deleted, false otherwise.
+     * 
+     */
+    bool deleteAllSMS(bool readOnly = false);
+
     /**
      * 
      * @brief Connect to an Access Point Name (APN) for mobile data.
@@ -184,7 +1184,7 @@ public:
      * @return True if the APN connection is successful, false otherwise.
      * 
      */
-    bool connectAPN(SIM900APN apn);
+    bool connectAPN(const SIM900APN& apn);
 
     /**
      * 
@@ -197,17 +1197,117 @@ public:
      */
     bool enableGPRS();
 
+    /**
+     * 
+     * @brief Enable the General Packet Radio Service (GPRS) without blocking.
+     *
+     * @param callback The callback invoked from poll() once the wireless connection is up or has failed.
+     * @return True if the command was submitted, false if no APN is configured or another command is still pending.
+     * 
+     */
+    bool enableGPRS(SIM900ResultCallback callback);
+
+    /**
+     * 
+     * @brief Enable the connection pool using multiple TCP connections (AT+CIPMUX=1).
+     *
+     * With the connection pool enabled, request() keeps up to SIM900_MAX_CONNECTIONS links open using HTTP/1.1
+     * keep-alive, and repeated requests to the same server reuse an open link instead of connecting again.
+     * This must be called before connectAPN(), while the module's IP stack is in its initial state.
+     *
+     * @return True if multiple connections were enabled, false otherwise.
+     * 
+     */
+    bool enableConnectionPool();
+
+    /**
+     * 
+     * @brief Synchronize the state of the pooled links with the module (AT+CIPSTATUS).
+     *
+     * @return True if the connection status was received, false otherwise.
+     * 
+     */
+    bool refreshConnections();
+
+    /**
+     * 
+     * @brief Get the state of a pooled link.
+     *
+     * @param link The link number, from 0 to SIM900_MAX_CONNECTIONS - 1.
+     * @return The state of the link, as a SIM900ConnectionState.
+     * 
+     */
+    SIM900ConnectionState connectionState(uint8_t link);
+
+    /**
+     * 
+     * @brief Close all open links of the connection pool.
+     * 
+     */
+    void closeConnections();
+
+    /**
+     * 
+     * @brief Select the backend which carries HTTP requests.
+     *
+     * With SIM900_HTTP_ENGINE_TCP (the default), requests are framed by the library and sent over a TCP connection.
+     * With SIM900_HTTP_ENGINE_BUILTIN, the HTTP stack of the module firmware is used instead: the response body is
+     * read back in windows of SIM900_HTTP_READ_SIZE bytes, but the response headers are not available, and only
+     * the GET, POST and HEAD methods are supported. Both engines require connectAPN() to be called first.
+     *
+     * @param engine The HTTP engine to use, as a SIM900HTTPEngine.
+     * 
+     */
+    void setHTTPEngine(SIM900HTTPEngine engine);
+
     /**
      * 
      * @brief Send an HTTP request to a remote server.
      *
-     * This function sends an HTTP request to a specified server with the provided request parameters.
+     * This function sends an HTTP request to a specified server with the provided request parameters, then parses
+     * the status line and headers of the response. The body is decoded according to its Content-Length or chunked
+     * transfer encoding and either passed to the sink callback in fixed-size chunks, or stored in the data field
+     * of the response if no sink is given.
+     *
+     * @param request An instance of the SIM900HTTPRequest structure representing the HTTP request.
+     * @param sink An optional callback receiving the response body, so large responses never have to fit in memory.
+     * @return A SIM900HTTPResponse structure containing the HTTP response from the server. Its headers remain valid until the next request.
+     * 
+     */
+    SIM900HTTPResponse request(const SIM900HTTPRequest& request, SIM900HTTPBodyCallback sink = NULL);
+
+    /**
+     * 
+     * @brief Send an HTTP request whose body is read from a stream.
+     *
+     * The data field of the request is ignored. The body is sent in chunks of at most SIM900_SEND_MTU bytes,
+     * each waiting for the module to acknowledge it before the next, so bodies of any size can be uploaded
+     * without holding them in memory.
      *
      * @param request An instance of the SIM900HTTPRequest structure representing the HTTP request.
+     * @param body The stream the request body is read from, such as an open file.
+     * @param length The number of bytes of the body, sent as its Content-Length.
+     * @param sink An optional callback receiving the response body.
      * @return A SIM900HTTPResponse structure containing the HTTP response from the server.
      * 
      */
-    SIM900HTTPResponse request(SIM900HTTPRequest request);
+    SIM900HTTPResponse request(const SIM900HTTPRequest& request, Stream& body, uint32_t length, SIM900HTTPBodyCallback sink = NULL);
+
+    /**
+     * 
+     * @brief Send an HTTP request whose body is produced by a callback.
+     *
+     * The data field of the request is ignored. The callback is asked for up to SIM900_HTTP_CHUNK_SIZE bytes at
+     * a time, and the body is sent in chunks of at most SIM900_SEND_MTU bytes as with the stream overload.
+     *
+     * @param request An instance of the SIM900HTTPRequest structure representing the HTTP request.
+     * @param body The callback producing the request body.
+     * @param length The number of bytes of the body, sent as its Content-Length.
+     * @param sink An optional callback receiving the response body.
+     * @return A SIM900HTTPResponse structure containing the HTTP response from the server.
+     * 
+     */
+    SIM900HTTPResponse request(const SIM900HTTPRequest& request, SIM900HTTPBodySource body, uint32_t length, SIM900HTTPBodyCallback sink = NULL);
 
     /**
      * 
@@ -220,6 +1320,16 @@ public:
      */
     SIM900Operator networkOperator();
 
+    /**
+     * 
+     * @brief Query the current network operator without blocking.
+     *
+     * @param callback The callback invoked from poll() with the success flag and the network operator information.
+     * @return True if the command was submitted, false if another command is still pending.
+     * 
+     */
+    bool networkOperator(SIM900OperatorCallback callback);
+
     /**
      * 
      * @brief Get the SIM card number.
@@ -267,7 +1377,7 @@ public:
      * @return True if the contact is successfully saved, false otherwise.
      * 
      */
-    bool savePhonebook(uint8_t index, SIM900CardAccount account);
+    bool savePhonebook(uint8_t index, const SIM900CardAccount& account);
 
     /**
      * 
@@ -293,6 +1403,78 @@ public:
      */
     SIM900CardAccount retrievePhonebook(uint8_t index);
 
+    /**
+     * 
+     * @brief Read a range of contacts from the SIM card's phonebook with a single command.
+     *
+     * The entries are parsed as they arrive and passed to the callback one at a time, so the range can be as large
+     * as the phonebook. Empty entries are skipped by the module and not passed to the callback.
+     *
+     * @param first The index of the first contact entry to read.
+     * @param last The index of the last contact entry to read.
+     * @param callback The callback receiving the index and information of each contact entry.
+     * @return A SIM900PhonebookReport structure with the number of entries read and the throughput.
+     * 
+     */
+    SIM900PhonebookReport readPhonebook(uint8_t first, uint8_t last, SIM900PhonebookCallback callback);
+
+    /**
+     * 
+     * @brief Read a range of contacts from the SIM card's phonebook into an array with a single command.
+     *
+     * The contact entry at index i is stored in accounts[i - first]. Elements of empty entries are cleared.
+     *
+     * @param first The index of the first contact entry to read.
+     * @param last The index of the last contact entry to read.
+     * @param accounts The array receiving the contact entries.
+     * @param size The number of elements of the array. Entries which do not fit are not stored.
+     * @return A SIM900PhonebookReport structure with the number of entries read and the throughput.
+     * 
+     */
+    SIM900PhonebookReport readPhonebook(uint8_t first, uint8_t last, SIM900CardAccount* accounts, uint8_t size);
+
+    /**
+     * 
+     * @brief Make the SIM card's phonebook match a list of contacts, writing only the entries which differ.
+     *
+     * The contact desired[i] is stored at index i + 1, and entries past the end of the list are deleted. A contact with
+     * an empty number deletes its entry. The phonebook is read once with a single range read, and only the entries which
+     * differ from the list are written or deleted.
+     *
+     * @param desired The array of contacts the phonebook should hold.
+     * @param count The number of contacts in the array, at most the capacity of the phonebook.
+     * @return A SIM900PhonebookReport structure with the number of entries written or deleted and the throughput.
+     * 
+     */
+    SIM900PhonebookReport syncPhonebook(SIM900CardAccount* desired, uint8_t count);
+
+    /**
+     * 
+     * @brief Build the in-memory phonebook index used by findPhonebook().
+     *
+     * The phonebook is read once with a single range read, and a 16-bit hash of each phone number is kept with its
+     * entry index. The index is then kept current by savePhonebook() and deletePhonebook(). It is only available
+     * when SIM900_PHONEBOOK_INDEX_SIZE is set to at least the capacity of the phonebook.
+     *
+     * @return True if the index holds every entry of the phonebook, false otherwise.
+     * 
+     */
+    bool buildPhonebookIndex();
+
+    /**
+     * 
+     * @brief Find the phonebook entry of a phone number, such as the caller of an incoming call.
+     *
+     * Numbers are compared on their trailing SIM900_PHONEBOOK_MATCH_DIGITS digits, so national and international
+     * forms of a number match. With a phonebook index, only the candidate entries are read back to rule out hash
+     * collisions. Without one, the phonebook is scanned with a single range read.
+     *
+     * @param number The phone number to look up.
+     * @return The index of the matching phonebook entry, or -1 if there is none.
+     * 
+     */
+    int16_t findPhonebook(String number);
+
     /**
      * 
      * @brief Get information about the capacity of the SIM card's phonebook.
@@ -305,6 +1487,40 @@ public:
      */
     SIM900PhonebookCapacity phonebookCapacity();
 
+    /**
+     * 
+     * @brief Query the capacity of the SIM card's phonebook without blocking.
+     *
+     * @param callback The callback invoked from poll() with the success flag and the phonebook capacity information.
+     * @return True if the command was submitted, false if another command is still pending.
+     * 
+     */
+    bool phonebookCapacity(SIM900PhonebookCapacityCallback callback);
+
+    /**
+     * 
+     * @brief Execute several queries as one concatenated command line.
+     *
+     * The queries selected in the batch are sent in a single round trip (e.g., AT+CSQ;+COPS?;+CPBS?;+CCLK?)
+     * and the combined response is demultiplexed into the result fields of the batch.
+     *
+     * @param batch The batch holding the queries to execute and receiving their results.
+     * @return True if the module answered the batch with OK, false otherwise.
+     * 
+     */
+    bool query(SIM900Batch& batch);
+
+    /**
+     * 
+     * @brief Execute several queries as one concatenated command line without blocking.
+     *
+     * @param batch The batch holding the queries to execute. It must remain valid until the callback is invoked.
+     * @param callback The callback invoked from poll() once the results were filled in.
+     * @return True if the command was submitted, false if no query was selected or another command is still pending.
+     * 
+     */
+    bool query(SIM900Batch& batch, SIM900ResultCallback callback);
+
     /**
      * 
      * @brief Get the manufacturer name of the SIM900 module.
@@ -360,4 +1576,8 @@ public:
     String ipAddress();
 };
 
+#include "sim900_impl.h"
+
+extern template class BasicSIM900<Stream, SIM900_RX_BUFFER_SIZE>;
+
 #endif
\ No newline at end of file
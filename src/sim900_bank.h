@@ -0,0 +1,488 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * 
+ * @file sim900_bank.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief This header defines a manager distributing work across a bank of SIM900 modules.
+ * 
+ */
+
+#ifndef SIM900_BANK_H
+#define SIM900_BANK_H
+
+#include "sim900.h"
+
+#ifndef SIM900_BANK_SIZE
+/// Maximum number of modules managed by a SIM900Bank.
+#define SIM900_BANK_SIZE 4
+#endif
+
+#ifndef SIM900_BANK_QUEUE_SIZE
+/// Maximum number of jobs waiting for an idle module in a SIM900Bank.
+#define SIM900_BANK_QUEUE_SIZE 16
+#endif
+
+#if SIM900_BANK_QUEUE_SIZE > 255
+#error "SIM900_BANK_QUEUE_SIZE must not exceed 255 jobs."
+#endif
+
+#ifndef SIM900_BANK_MAX_FAILURES
+/// Number of consecutive failed jobs after which a module is taken out of rotation.
+#define SIM900_BANK_MAX_FAILURES 3
+#endif
+
+#ifndef SIM900_BANK_BACKOFF
+/// Time in milliseconds a failing module is left out of rotation before it is given another job.
+#define SIM900_BANK_BACKOFF 30000
+#endif
+
+/**
+ * 
+ * @enum SIM900BankJobType
+ * @brief An enumeration representing the kinds of work a SIM900Bank can hand out.
+ * 
+ */
+typedef enum _SIM900BankJobType {
+    /// Send an SMS message, as SIM900::sendSMS().
+    SIM900_BANK_JOB_SMS,
+
+    /// Execute a batch of queries, as SIM900::query().
+    SIM900_BANK_JOB_QUERY,
+
+    /// Execute an AT command, as SIM900::submit().
+    SIM900_BANK_JOB_COMMAND
+} SIM900BankJobType;
+
+/**
+ * 
+ * @struct SIM900BankJob
+ * @brief A structure representing a unit of work queued on a SIM900Bank.
+ *
+ * The job only refers to its data, which is owned by the caller and must remain valid until the job completes.
+ * 
+ */
+typedef struct _SIM900BankJob {
+    /// The kind of work to carry out.
+    SIM900BankJobType type;
+
+    union {
+        /// The message to send, for SIM900_BANK_JOB_SMS. Its sent and reference fields are filled in on completion.
+        SIM900SMS* sms;
+
+        /// The batch to execute, for SIM900_BANK_JOB_QUERY.
+        SIM900Batch* batch;
+
+        /// The AT command to execute, for SIM900_BANK_JOB_COMMAND.
+        const char* command;
+    };
+} SIM900BankJob;
+
+/**
+ * 
+ * @struct SIM900BankHealth
+ * @brief A structure representing the activity and health of a module in a SIM900Bank.
+ * 
+ */
+typedef struct _SIM900BankHealth {
+    /// A flag indicating whether the module is carrying out a job.
+    bool busy;
+
+    /// A flag indicating whether the module is in rotation, false while it backs off after repeated failures.
+    bool available;
+
+    /// The number of jobs the module completed successfully.
+    uint32_t completed;
+
+    /// The number of jobs which failed on the module.
+    uint32_t failed;
+
+    /// The number of jobs which failed on the module since its last successful one.
+    uint8_t consecutive_failures;
+
+    /// The time in milliseconds at which the module last completed a job.
+    uint32_t last_active;
+} SIM900BankHealth;
+
+/// Callback invoked from SIM900Bank::poll() when a job completes on the module at the given index.
+typedef void (*SIM900BankCallback)(uint8_t modem, const SIM900BankJob& job, bool success);
+
+/**
+ * 
+ * @class BasicSIM900Bank
+ * @brief A class distributing SMS messages, queries and commands across a bank of SIM900 modules.
+ *
+ * Jobs are queued on the bank and handed to whichever module is idle, so the throughput grows with the number of
+ * modules. All modules are driven from a single loop through their non-blocking interface: poll() advances every
+ * module, collects the results of completed jobs and starts the next queued ones. A module whose jobs keep failing
+ * is left out of rotation for SIM900_BANK_BACKOFF milliseconds.
+ *
+ * @tparam Modem The SIM900 class of the modules, such as SIM900 or a BasicSIM900 bound to another transport.
+ * 
+ */
+template<class Modem>
+class BasicSIM900Bank {
+private:
+    /// The modules of the bank.
+    Modem* modems[SIM900_BANK_SIZE];
+
+    /// The activity and health of each module.
+    SIM900BankHealth states[SIM900_BANK_SIZE];
+
+    /// The job each busy module is carrying out.
+    SIM900BankJob running[SIM900_BANK_SIZE];
+
+    /// The number of modules in the bank.
+    uint8_t modemCount = 0;
+
+    /// The module the next job is offered to first, so work is spread evenly.
+    uint8_t nextModem = 0;
+
+    /// The jobs waiting for an idle module, as a ring buffer.
+    SIM900BankJob queue[SIM900_BANK_QUEUE_SIZE];
+
+    /// The position of the oldest waiting job in the queue.
+    uint8_t queueHead = 0;
+
+    /// The number of waiting jobs.
+    uint8_t queueCount = 0;
+
+    /// The callback invoked when a job completes.
+    SIM900BankCallback callback;
+
+    /// Add a job to the queue, returning false if it is full.
+    bool enqueue(const SIM900BankJob& job);
+
+    /// Check if a module can be given a job.
+    bool isAvailable(uint8_t modem);
+
+    /// Start a job on a module, returning false if the module did not accept it.
+    bool dispatch(uint8_t modem, const SIM900BankJob& job);
+
+    /// Record the result of the job of a module and report it to the callback.
+    void complete(uint8_t modem);
+
+public:
+    /**
+     * 
+     * @brief Constructor for the BasicSIM900Bank class.
+     *
+     * @param callback An optional callback invoked from poll() whenever a job completes.
+     * 
+     */
+    BasicSIM900Bank(SIM900BankCallback callback = NULL);
+
+    /**
+     * 
+     * @brief Add a module to the bank.
+     *
+     * The module is driven by the bank from then on, and should not be given commands directly while the bank has
+     * queued jobs. Its unsolicited result code handlers keep working, since they run from poll().
+     *
+     * @param modem The module to add. It is not copied and must remain valid.
+     * @return The index of the module in the bank, or -1 if the bank is full.
+     * 
+     */
+    int8_t add(Modem& modem);
+
+    /**
+     * 
+     * @brief Queue an SMS message to be sent by the next idle module.
+     *
+     * @param sms The message to send. Its sent and reference fields are filled in once the job completes.
+     * @return True if the job was queued, false if the queue is full.
+     * 
+     */
+    bool sendSMS(SIM900SMS& sms);
+
+    /**
+     * 
+     * @brief Queue a batch of queries to be executed by the next idle module.
+     *
+     * @param batch The batch to execute, filled in once the job completes.
+     * @return True if the job was queued, false if the queue is full.
+     * 
+     */
+    bool query(SIM900Batch& batch);
+
+    /**
+     * 
+     * @brief Queue an AT command to be executed by the next idle module.
+     *
+     * The response can be read with lastResponse() on the module passed to the callback.
+     *
+     * @param command The AT command to execute. It is not copied and must remain valid until the job completes.
+     * @return True if the job was queued, false if the queue is full.
+     * 
+     */
+    bool submit(const char* command);
+
+    /**
+     * 
+     * @brief Advance every module of the bank, completing finished jobs and starting queued ones.
+     *
+     * This function never blocks and should be called repeatedly from the main loop.
+     *
+     * @return The number of jobs which completed during this call.
+     * 
+     */
+    uint8_t poll();
+
+    /**
+     * 
+     * @brief Get the number of modules in the bank.
+     *
+     * @return The number of modules.
+     * 
+     */
+    uint8_t size();
+
+    /**
+     * 
+     * @brief Get the number of jobs waiting for an idle module.
+     *
+     * @return The depth of the job queue.
+     * 
+     */
+    uint8_t queued();
+
+    /**
+     * 
+     * @brief Get the number of jobs being carried out by the modules.
+     *
+     * @return The number of busy modules.
+     * 
+     */
+    uint8_t active();
+
+    /**
+     * 
+     * @brief Get the activity and health of a module.
+     *
+     * @param modem The index of the module.
+     * @return The state of the module, as a SIM900BankHealth structure.
+     * 
+     */
+    SIM900BankHealth health(uint8_t modem);
+
+    /**
+     * 
+     * @brief Get a module of the bank.
+     *
+     * @param modem The index of the module.
+     * @return A reference to the module.
+     * 
+     */
+    Modem& modem(uint8_t modem);
+};
+
+/// A bank of SIM900 modules communicating through Arduino Streams.
+typedef BasicSIM900Bank<SIM900> SIM900Bank;
+
+template<class Modem>
+BasicSIM900Bank<Modem>::BasicSIM900Bank(SIM900BankCallback callback):callback(callback) { }
+
+template<class Modem>
+int8_t BasicSIM900Bank<Modem>::add(Modem& modem) {
+    if(this->modemCount >= SIM900_BANK_SIZE)
+        return -1;
+
+    SIM900BankHealth& state = this->states[this->modemCount];
+    state.busy = false;
+    state.available = true;
+    state.completed = state.failed = 0;
+    state.consecutive_failures = 0;
+    state.last_active = 0;
+
+    this->modems[this->modemCount] = &modem;
+    return this->modemCount++;
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::enqueue(const SIM900BankJob& job) {
+    if(this->queueCount >= SIM900_BANK_QUEUE_SIZE)
+        return false;
+
+    this->queue[(this->queueHead + this->queueCount) % SIM900_BANK_QUEUE_SIZE] = job;
+    this->queueCount++;
+
+    return true;
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::sendSMS(SIM900SMS& sms) {
+    SIM900BankJob job;
+    job.type = SIM900_BANK_JOB_SMS;
+    job.sms = &sms;
+
+    return this->enqueue(job);
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::query(SIM900Batch& batch) {
+    SIM900BankJob job;
+    job.type = SIM900_BANK_JOB_QUERY;
+    job.batch = &batch;
+
+    return this->enqueue(job);
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::submit(const char* command) {
+    SIM900BankJob job;
+    job.type = SIM900_BANK_JOB_COMMAND;
+    job.command = command;
+
+    return this->enqueue(job);
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::isAvailable(uint8_t modem) {
+    SIM900BankHealth& state = this->states[modem];
+    if(state.busy || this->modems[modem]->isBusy())
+        return false;
+
+    if(!state.available && millis() - state.last_active >= SIM900_BANK_BACKOFF)
+        state.available = true;
+
+    return state.available;
+}
+
+template<class Modem>
+bool BasicSIM900Bank<Modem>::dispatch(uint8_t modem, const SIM900BankJob& job) {
+    Modem* sim900 = this->modems[modem];
+
+    switch(job.type) {
+        case SIM900_BANK_JOB_SMS:
+            job.sms->sent = false;
+            job.sms->reference = -1;
+
+            return sim900->sendSMS(job.sms->number, job.sms->message, NULL);
+
+        case SIM900_BANK_JOB_QUERY:
+            return sim900->query(*job.batch, NULL);
+
+        case SIM900_BANK_JOB_COMMAND:
+            return sim900->submit(job.command);
+    }
+
+    return false;
+}
+
+template<class Modem>
+void BasicSIM900Bank<Modem>::complete(uint8_t modem) {
+    SIM900BankHealth& state = this->states[modem];
+    SIM900BankJob& job = this->running[modem];
+    bool success = this->modems[modem]->status() == SIM900_COMMAND_OK;
+
+    if(success && job.type == SIM900_BANK_JOB_SMS) {
+        job.sms->sent = true;
+        job.sms->reference = this->modems[modem]->smsReference();
+    }
+
+    state.busy = false;
+    state.last_active = millis();
+
+    if(success) {
+        state.completed++;
+        state.consecutive_failures = 0;
+    }
+    else {
+        state.failed++;
+
+        if(state.consecutive_failures < 255)
+            state.consecutive_failures++;
+        if(state.consecutive_failures >= SIM900_BANK_MAX_FAILURES)
+            state.available = false;
+    }
+
+    if(this->callback != NULL)
+        this->callback(modem, job, success);
+}
+
+template<class Modem>
+uint8_t BasicSIM900Bank<Modem>::poll() {
+    uint8_t completed = 0;
+
+    for(uint8_t i = 0; i < this->modemCount; i++) {
+        this->modems[i]->poll();
+
+        if(this->states[i].busy && !this->modems[i]->isBusy()) {
+            this->complete(i);
+            completed++;
+        }
+    }
+
+    for(uint8_t tried = 0; this->queueCount > 0 && tried < this->modemCount; tried++) {
+        uint8_t modem = this->nextModem;
+        this->nextModem = (this->nextModem + 1) % this->modemCount;
+
+        if(!this->isAvailable(modem))
+            continue;
+
+        SIM900BankJob& job = this->queue[this->queueHead];
+        if(!this->dispatch(modem, job))
+            continue;
+
+        this->running[modem] = job;
+        this->states[modem].busy = true;
+
+        this->queueHead = (this->queueHead + 1) % SIM900_BANK_QUEUE_SIZE;
+        this->queueCount--;
+    }
+
+    return completed;
+}
+
+template<class Modem>
+uint8_t BasicSIM900Bank<Modem>::size() {
+    return this->modemCount;
+}
+
+template<class Modem>
+uint8_t BasicSIM900Bank<Modem>::queued() {
+    return this->queueCount;
+}
+
+template<class Modem>
+uint8_t BasicSIM900Bank<Modem>::active() {
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < this->modemCount; i++)
+        if(this->states[i].busy)
+            count++;
+
+    return count;
+}
+
+template<class Modem>
+SIM900BankHealth BasicSIM900Bank<Modem>::health(uint8_t modem) {
+    return this->states[modem];
+}
+
+template<class Modem>
+Modem& BasicSIM900Bank<Modem>::modem(uint8_t modem) {
+    return *this->modems[modem];
+}
+
+#endif
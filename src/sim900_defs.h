@@ -32,6 +32,134 @@
 #ifndef SIM900_DEFS_H
 #define SIM900_DEFS_H
 
+#ifndef SIM900_NUMBER_SIZE
+/// Maximum length of a phone number, including its leading '+', when SIM900_FIXED_STRINGS is defined.
+#define SIM900_NUMBER_SIZE 24
+#endif
+
+#ifndef SIM900_NAME_SIZE
+/// Maximum length of a phonebook entry or network operator name when SIM900_FIXED_STRINGS is defined.
+#define SIM900_NAME_SIZE 24
+#endif
+
+#ifndef SIM900_APN_SIZE
+/// Maximum length of an Access Point Name, username or password when SIM900_FIXED_STRINGS is defined.
+#define SIM900_APN_SIZE 50
+#endif
+
+#ifndef SIM900_DOMAIN_SIZE
+/// Maximum length of the domain of an HTTP request when SIM900_FIXED_STRINGS is defined.
+#define SIM900_DOMAIN_SIZE 64
+#endif
+
+#ifndef SIM900_RESOURCE_SIZE
+/// Maximum length of the resource path of an HTTP request when SIM900_FIXED_STRINGS is defined.
+#define SIM900_RESOURCE_SIZE 128
+#endif
+
+#ifndef SIM900_HTTP_DATA_SIZE
+/// Maximum length of the body held in an HTTP request when SIM900_FIXED_STRINGS is defined.
+#define SIM900_HTTP_DATA_SIZE 256
+#endif
+
+#ifndef SIM900_HEADER_KEY_SIZE
+/// Maximum length of an HTTP header field name when SIM900_FIXED_STRINGS is defined.
+#define SIM900_HEADER_KEY_SIZE 32
+#endif
+
+#ifndef SIM900_HEADER_VALUE_SIZE
+/// Maximum length of an HTTP header field value when SIM900_FIXED_STRINGS is defined.
+#define SIM900_HEADER_VALUE_SIZE 64
+#endif
+
+#ifdef SIM900_FIXED_STRINGS
+/**
+ * 
+ * @class SIM900FixedString
+ * @brief A string stored inline in a fixed-capacity buffer, used for the text fields of the SIM900 structures when
+ * SIM900_FIXED_STRINGS is defined.
+ *
+ * Text longer than the capacity is truncated. The string converts to a null-terminated C string, so it can be printed,
+ * compared and appended to an Arduino String like one.
+ *
+ * @tparam Capacity The maximum number of characters the string can hold.
+ * 
+ */
+template<uint16_t Capacity>
+class SIM900FixedString {
+private:
+    /// The characters of the string, followed by a null terminator.
+    char text[Capacity + 1];
+
+public:
+    SIM900FixedString() {
+        this->text[0] = '\0';
+    }
+
+    SIM900FixedString(const char* value) {
+        *this = value;
+    }
+
+    SIM900FixedString(const __FlashStringHelper* value) {
+        *this = value;
+    }
+
+    SIM900FixedString(const String& value) {
+        *this = value.c_str();
+    }
+
+    SIM900FixedString& operator=(const char* value) {
+        strncpy(this->text, value, Capacity);
+        this->text[Capacity] = '\0';
+
+        return *this;
+    }
+
+    SIM900FixedString& operator=(const __FlashStringHelper* value) {
+        strncpy_P(this->text, reinterpret_cast<const char*>(value), Capacity);
+        this->text[Capacity] = '\0';
+
+        return *this;
+    }
+
+    SIM900FixedString& operator=(const String& value) {
+        return *this = value.c_str();
+    }
+
+    operator const char*() const {
+        return this->text;
+    }
+
+    const char* c_str() const {
+        return this->text;
+    }
+
+    uint16_t length() const {
+        return strlen(this->text);
+    }
+
+    bool operator==(const char* value) const {
+        return strcmp(this->text, value) == 0;
+    }
+
+    bool operator!=(const char* value) const {
+        return strcmp(this->text, value) != 0;
+    }
+
+    bool equalsIgnoreCase(const __FlashStringHelper* value) const {
+        return strcasecmp_P(this->text, reinterpret_cast<const char*>(value)) == 0;
+    }
+};
+
+/// A text field holding up to Capacity characters inline.
+template<uint16_t Capacity>
+using SIM900Text = SIM900FixedString<Capacity>;
+#else
+/// A text field, held in a heap-allocated String unless SIM900_FIXED_STRINGS is defined.
+template<uint16_t Capacity>
+using SIM900Text = String;
+#endif
+
 /**
  * 
  * @enum SIM900DialResult
@@ -61,6 +189,35 @@ typedef enum _SIM900DialResult {
     SIM900_DIAL_RESULT_OK
 } SIM900DialResult;
 
+/**
+ * 
+ * @enum SIM900CommandStatus
+ * @brief An enumeration representing the state of a command processed by the SIM900 command engine.
+ *
+ * Commands submitted to the SIM900 module are tracked by a state machine which is advanced by SIM900::poll().
+ * This enumeration describes where the most recent command is in its lifecycle and how it ended.
+ * 
+ */
+typedef enum _SIM900CommandStatus {
+    /// No command has been submitted yet.
+    SIM900_COMMAND_IDLE,
+
+    /// The command was sent and its final result code has not arrived yet.
+    SIM900_COMMAND_PENDING,
+
+    /// The command completed with a successful final result code (e.g., OK, CONNECT OK, SEND OK).
+    SIM900_COMMAND_OK,
+
+    /// The command completed with an error or failure result code (e.g., ERROR, +CME ERROR, NO CARRIER).
+    SIM900_COMMAND_ERROR,
+
+    /// The module is waiting for data after showing the '>' prompt.
+    SIM900_COMMAND_PROMPT,
+
+    /// No final result code arrived before the command deadline.
+    SIM900_COMMAND_TIMEOUT
+} SIM900CommandStatus;
+
 /**
  * 
  * @enum SIM900OperatorFormat
@@ -240,7 +397,7 @@ typedef struct _SIM900Operator {
     SIM900OperatorFormat format;
 
     /// The name of the mobile network operator.
-    String name;
+    SIM900Text<SIM900_NAME_SIZE> name;
 } SIM900Operator;
 
 /**
@@ -284,13 +441,13 @@ typedef struct _SIM900RTC {
  */
 typedef struct _SIM900APN {
     /// The Access Point Name (APN) for data connectivity.
-    String apn;
+    SIM900Text<SIM900_APN_SIZE> apn;
 
     /// The username for APN authentication.
-    String username;
+    SIM900Text<SIM900_APN_SIZE> username;
 
     /// The password for APN authentication.
-    String password;
+    SIM900Text<SIM900_APN_SIZE> password;
 } SIM900APN;
 
 /**
@@ -303,10 +460,10 @@ typedef struct _SIM900APN {
  */
 typedef struct _SIM900HTTPHeader {
     /// The header field key.
-    String key;
+    SIM900Text<SIM900_HEADER_KEY_SIZE> key;
 
     /// The header field value.
-    String value;
+    SIM900Text<SIM900_HEADER_VALUE_SIZE> value;
 } SIM900HTTPHeader;
 
 /**
@@ -320,16 +477,16 @@ typedef struct _SIM900HTTPHeader {
  */
 typedef struct _SIM900HTTPRequest {
     /// The HTTP method for the request (e.g., GET, POST).
-    String method;
+    SIM900Text<8> method;
 
     /// The data to be included in the request (e.g., POST data).
-    String data;
+    SIM900Text<SIM900_HTTP_DATA_SIZE> data;
 
     /// The domain or server to which the request is sent.
-    String domain;
+    SIM900Text<SIM900_DOMAIN_SIZE> domain;
 
     /// The resource or URL path to access on the server.
-    String resource;
+    SIM900Text<SIM900_RESOURCE_SIZE> resource;
 
     /// The status of the HTTP request.
     uint8_t status;
@@ -363,8 +520,14 @@ typedef struct _SIM900HTTPResponse {
     /// The number of HTTP headers in the array.
     uint16_t header_count;
 
-    /// The data received in the HTTP response, such as HTML content or JSON data.
+    /// The data received in the HTTP response, such as HTML content or JSON data. Left empty when the body is passed to a sink callback.
     String data;
+
+    /// The time in milliseconds from sending the request until the first byte of the response arrived.
+    uint32_t ttfb;
+
+    /// The total time in milliseconds taken by the request, including connection setup and teardown.
+    uint32_t elapsed;
 } SIM900HTTPResponse;
 
 /**
@@ -378,10 +541,10 @@ typedef struct _SIM900HTTPResponse {
  */
 typedef struct _SIM900CardAccount {
     /// The name associated with the card account.
-    String name;
+    SIM900Text<SIM900_NAME_SIZE> name;
     
     /// The card's phone number.
-    String number;
+    SIM900Text<SIM900_NUMBER_SIZE> number;
 
     /// The card's type (e.g., SIM card).
     uint8_t type;
@@ -407,7 +570,7 @@ typedef struct _SIM900CardAccount {
  */
 typedef struct _SIM900PhonebookCapacity {
     /// The type of phonebook memory (e.g., "SM" for SIM memory).
-    String memoryType;
+    SIM900Text<4> memoryType;
 
     /// The number of entries used in the phonebook memory.
     uint8_t used;
@@ -433,4 +596,217 @@ typedef struct _SIM900Signal {
     uint8_t bit_error_rate;
 } SIM900Signal;
 
+/**
+ * 
+ * @struct SIM900SMS
+ * @brief A structure representing one message of an SMS batch and the outcome of sending it.
+ * 
+ */
+typedef struct _SIM900SMS {
+    /// The phone number of the recipient.
+    String number;
+
+    /// The text of the message.
+    String message;
+
+    /// A flag indicating whether the message was accepted by the network.
+    bool sent;
+
+    /// The message reference returned by the network (+CMGS), or -1 if the message was not sent.
+    int16_t reference;
+} SIM900SMS;
+
+/**
+ * 
+ * @struct SIM900SMSReport
+ * @brief A structure summarizing the outcome of sending an SMS batch.
+ * 
+ */
+typedef struct _SIM900SMSReport {
+    /// The number of messages accepted by the network.
+    uint16_t sent;
+
+    /// The number of messages which could not be sent.
+    uint16_t failed;
+
+    /// The time in milliseconds taken to send the whole batch.
+    uint32_t elapsed;
+
+    /// The throughput of the batch in messages sent per minute.
+    uint16_t per_minute;
+} SIM900SMSReport;
+
+/**
+ * 
+ * @struct SIM900PhonebookReport
+ * @brief A structure summarizing a bulk operation on the phonebook.
+ * 
+ */
+typedef struct _SIM900PhonebookReport {
+    /// A flag indicating whether the module completed the operation successfully.
+    bool success;
+
+    /// The number of phonebook entries processed.
+    uint16_t entries;
+
+    /// The time in milliseconds taken by the operation.
+    uint32_t elapsed;
+
+    /// The throughput of the operation in entries per second.
+    uint16_t per_second;
+} SIM900PhonebookReport;
+
+/**
+ * 
+ * @struct SIM900ReceivedSMS
+ * @brief A structure representing an SMS message read from the message storage of the SIM900 module.
+ * 
+ */
+typedef struct _SIM900ReceivedSMS {
+    /// The index of the message in the message storage.
+    uint16_t index;
+
+    /// The status of the message (e.g., "REC UNREAD", "REC READ").
+    String status;
+
+    /// The phone number of the sender.
+    String number;
+
+    /// The time at which the message was received by the service center.
+    SIM900RTC timestamp;
+
+    /// The text of the message.
+    String message;
+} SIM900ReceivedSMS;
+
+/**
+ * 
+ * @enum SIM900ConnectionState
+ * @brief An enumeration representing the state of a TCP connection link of the SIM900 module.
+ * 
+ */
+typedef enum _SIM900ConnectionState {
+    /// The link is not connected and can be used for a new connection.
+    SIM900_CONNECTION_CLOSED,
+
+    /// A connection is being established on the link.
+    SIM900_CONNECTION_CONNECTING,
+
+    /// The link is connected and can be reused for further requests.
+    SIM900_CONNECTION_CONNECTED,
+
+    /// The link is being closed by either side.
+    SIM900_CONNECTION_CLOSING
+} SIM900ConnectionState;
+
+/**
+ * 
+ * @struct SIM900Connection
+ * @brief A structure representing a TCP connection link kept open by the connection pool.
+ * 
+ */
+typedef struct _SIM900Connection {
+    /// The domain or server the link is connected to.
+    SIM900Text<SIM900_DOMAIN_SIZE> domain;
+
+    /// The port on the server the link is connected to.
+    uint16_t port;
+
+    /// The current state of the link.
+    SIM900ConnectionState state;
+
+    /// The time in milliseconds at which the link was last used.
+    uint32_t lastUsed;
+} SIM900Connection;
+
+/**
+ * 
+ * @enum SIM900HTTPEngine
+ * @brief An enumeration of the backends which can carry HTTP requests.
+ * 
+ */
+typedef enum _SIM900HTTPEngine {
+    /// Requests are framed by the library and sent over a raw TCP connection (AT+CIPSTART).
+    SIM900_HTTP_ENGINE_TCP,
+
+    /// Requests are handled by the HTTP stack of the module firmware (AT+HTTPINIT).
+    SIM900_HTTP_ENGINE_BUILTIN
+} SIM900HTTPEngine;
+
+/**
+ * 
+ * @enum SIM900Readiness
+ * @brief An enumeration of the stages the SIM900 module goes through while booting.
+ *
+ * The values are bit flags. Reaching a stage also marks the stages before it as reached.
+ * 
+ */
+typedef enum _SIM900Readiness {
+    /// The module is powered and answers commands (RDY).
+    SIM900_READY_BOOTED     = 0x01,
+
+    /// The module is in full functionality mode (+CFUN: 1).
+    SIM900_READY_FUNCTIONAL = 0x02,
+
+    /// The SIM card is unlocked and ready (+CPIN: READY).
+    SIM900_READY_SIM        = 0x04,
+
+    /// Calls can be made and received (Call Ready).
+    SIM900_READY_CALL       = 0x08,
+
+    /// SMS messages can be sent and received (SMS Ready).
+    SIM900_READY_SMS        = 0x10
+} SIM900Readiness;
+
+/**
+ * 
+ * @enum SIM900Query
+ * @brief An enumeration of the queries which can be combined into a single batched command line.
+ *
+ * The values are bit flags and can be combined with the bitwise OR operator.
+ * 
+ */
+typedef enum _SIM900Query {
+    /// Signal strength and bit error rate (AT+CSQ).
+    SIM900_QUERY_SIGNAL             = 0x01,
+
+    /// Current network operator (AT+COPS?).
+    SIM900_QUERY_OPERATOR           = 0x02,
+
+    /// Phonebook memory type and capacity (AT+CPBS?).
+    SIM900_QUERY_PHONEBOOK_CAPACITY = 0x04,
+
+    /// Real-time clock (AT+CCLK?).
+    SIM900_QUERY_RTC                = 0x08
+} SIM900Query;
+
+/**
+ * 
+ * @struct SIM900Batch
+ * @brief A structure holding a set of queries sent as one concatenated command line, and their results.
+ *
+ * Set the queries field to the SIM900Query flags to execute. Once the batch completes, the received field holds the
+ * flags of the queries whose results were found in the response, and the matching result fields are filled in.
+ * 
+ */
+typedef struct _SIM900Batch {
+    /// The SIM900Query flags of the queries to execute.
+    uint8_t queries;
+
+    /// The SIM900Query flags of the queries whose results were received.
+    uint8_t received;
+
+    /// The result of the SIM900_QUERY_SIGNAL query.
+    SIM900Signal signal;
+
+    /// The result of the SIM900_QUERY_OPERATOR query.
+    SIM900Operator networkOperator;
+
+    /// The result of the SIM900_QUERY_PHONEBOOK_CAPACITY query.
+    SIM900PhonebookCapacity phonebookCapacity;
+
+    /// The result of the SIM900_QUERY_RTC query.
+    SIM900RTC rtc;
+} SIM900Batch;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,2716 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SIM900_IMPL_H
+#define SIM900_IMPL_H
+
+static const char SIM900_URC_RING[] PROGMEM = "RING";
+static const char SIM900_URC_CRING[] PROGMEM = "+CRING:";
+static const char SIM900_URC_CLIP[] PROGMEM = "+CLIP:";
+static const char SIM900_URC_CMTI[] PROGMEM = "+CMTI:";
+static const char SIM900_URC_CMT[] PROGMEM = "+CMT:";
+static const char SIM900_URC_CUSD[] PROGMEM = "+CUSD:";
+static const char SIM900_URC_CLOSED[] PROGMEM = "CLOSED";
+static const char SIM900_URC_PDP_DEACT[] PROGMEM = "+PDP: DEACT";
+static const char SIM900_URC_RDY[] PROGMEM = "RDY";
+static const char SIM900_URC_CFUN[] PROGMEM = "+CFUN:";
+static const char SIM900_URC_CPIN[] PROGMEM = "+CPIN:";
+static const char SIM900_URC_CALL_READY[] PROGMEM = "Call Ready";
+static const char SIM900_URC_SMS_READY[] PROGMEM = "SMS Ready";
+static const char SIM900_URC_UNDER_VOLTAGE[] PROGMEM = "UNDER-VOLTAGE";
+static const char SIM900_URC_OVER_VOLTAGE[] PROGMEM = "OVER-VOLTAGE";
+static const char SIM900_URC_POWER_DOWN[] PROGMEM = "NORMAL POWER DOWN";
+
+/// Baud rates probed by SIM900::detectBaudRate(), most common first.
+static const uint32_t SIM900_BAUD_RATES[] PROGMEM = {
+    9600, 115200, 57600, 38400, 19200, 4800, 2400, 1200
+};
+
+/// A Print which only counts the bytes written to it, used to measure data before sending it.
+class SIM900LengthCounter : public Print {
+public:
+    size_t write(uint8_t) {
+        return 1;
+    }
+
+    size_t write(const uint8_t*, size_t size) {
+        return size;
+    }
+};
+
+/// The commands sent by SIM900::query(), in the order of the SIM900Query bits.
+static const char SIM900_QUERY_CSQ[] PROGMEM = "AT+CSQ";
+static const char SIM900_QUERY_COPS[] PROGMEM = "AT+COPS?";
+static const char SIM900_QUERY_CPBS[] PROGMEM = "AT+CPBS?";
+static const char SIM900_QUERY_CCLK[] PROGMEM = "AT+CCLK?";
+
+static const char* const SIM900_QUERY_COMMANDS[] PROGMEM = {
+    SIM900_QUERY_CSQ,
+    SIM900_QUERY_COPS,
+    SIM900_QUERY_CPBS,
+    SIM900_QUERY_CCLK
+};
+
+/// The commands selected by a set of SIM900Query bits, printed as a chain of ";" separated extended commands.
+class SIM900QueryList : public Printable {
+private:
+    /// The SIM900Query bits of the commands to print.
+    uint8_t queries;
+
+public:
+    explicit SIM900QueryList(uint8_t _queries):queries(_queries) {}
+
+    size_t printTo(Print& out) const {
+        size_t length = 0;
+
+        for(uint8_t i = 0; i < sizeof(SIM900_QUERY_COMMANDS) / sizeof(SIM900_QUERY_COMMANDS[0]); i++)
+            if(this->queries & (1 << i)) {
+                const char* command = (const char*) pgm_read_ptr(&SIM900_QUERY_COMMANDS[i]);
+
+                length += out.print(';');
+                length += out.print(reinterpret_cast<const __FlashStringHelper*>(command + 2));
+            }
+
+        return length;
+    }
+};
+
+/// A number below 100 printed with two digits, as in the fields of the real-time clock (AT+CCLK).
+class SIM900TwoDigits : public Printable {
+private:
+    /// The number to print.
+    uint8_t value;
+
+public:
+    explicit SIM900TwoDigits(uint8_t _value):value(_value) {}
+
+    size_t printTo(Print& out) const {
+        size_t length = out.print((char) ('0' + this->value / 10 % 10));
+        return length + out.print((char) ('0' + this->value % 10));
+    }
+};
+
+/// A Print which forwards only a window of the bytes written to it, used to send data in several parts.
+class SIM900WindowPrint : public Print {
+private:
+    /// The Print receiving the bytes inside the window.
+    Print& out;
+
+    /// The number of bytes to skip before the window.
+    uint32_t skip;
+
+    /// The number of bytes left in the window.
+    uint32_t left;
+
+public:
+    SIM900WindowPrint(Print& _out, uint32_t offset, uint32_t length):
+        out(_out), skip(offset), left(length) {}
+
+    size_t write(uint8_t data) {
+        return this->write(&data, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t size) {
+        size_t skipped = (size_t) min((uint32_t) size, this->skip);
+        size_t count = (size_t) min((uint32_t) (size - skipped), this->left);
+
+        this->skip -= skipped;
+        this->left -= count;
+
+        if(count > 0)
+            this->out.write(data + skipped, count);
+
+        return size;
+    }
+};
+
+/// Prefixes of the unsolicited result codes recognised without a registered handler.
+static const char* const SIM900_URCS[] PROGMEM = {
+    SIM900_URC_RING,
+    SIM900_URC_CRING,
+    SIM900_URC_CLIP,
+    SIM900_URC_CMTI,
+    SIM900_URC_CMT,
+    SIM900_URC_CUSD,
+    SIM900_URC_CLOSED,
+    SIM900_URC_PDP_DEACT,
+    SIM900_URC_RDY,
+    SIM900_URC_CFUN,
+    SIM900_URC_CPIN,
+    SIM900_URC_CALL_READY,
+    SIM900_URC_SMS_READY,
+    SIM900_URC_UNDER_VOLTAGE,
+    SIM900_URC_OVER_VOLTAGE,
+    SIM900_URC_POWER_DOWN
+};
+
+static const char SIM900_RESULT_OK[] PROGMEM = "OK";
+static const char SIM900_RESULT_ERROR[] PROGMEM = "ERROR";
+static const char SIM900_RESULT_CME_ERROR[] PROGMEM = "+CME ERROR";
+static const char SIM900_RESULT_CMS_ERROR[] PROGMEM = "+CMS ERROR";
+static const char SIM900_RESULT_SEND_OK[] PROGMEM = "SEND OK";
+static const char SIM900_RESULT_CONNECT_OK[] PROGMEM = "CONNECT OK";
+static const char SIM900_RESULT_ALREADY_CONNECT[] PROGMEM = "ALREADY CONNECT";
+static const char SIM900_RESULT_CLOSE_OK[] PROGMEM = "CLOSE OK";
+static const char SIM900_RESULT_SHUT_OK[] PROGMEM = "SHUT OK";
+static const char SIM900_RESULT_DOWNLOAD[] PROGMEM = "DOWNLOAD";
+static const char SIM900_RESULT_NO_CARRIER[] PROGMEM = "NO CARRIER";
+static const char SIM900_RESULT_NO_DIALTONE[] PROGMEM = "NO DIALTONE";
+static const char SIM900_RESULT_NO_ANSWER[] PROGMEM = "NO ANSWER";
+static const char SIM900_RESULT_BUSY[] PROGMEM = "BUSY";
+static const char SIM900_RESULT_CONNECT_FAIL[] PROGMEM = "CONNECT FAIL";
+static const char SIM900_RESULT_SEND_FAIL[] PROGMEM = "SEND FAIL";
+
+/// A final result code and the command and dial status it maps to.
+typedef struct _SIM900ResultCode {
+    /// The result code, or its prefix if match_prefix is set.
+    const char* code;
+
+    /// The command status reported for the result code.
+    uint8_t status;
+
+    /// The dial result reported for the result code.
+    uint8_t dial;
+
+    /// Match any line starting with the code, such as "+CME ERROR: 10".
+    bool match_prefix;
+} SIM900ResultCode;
+
+/// Final result codes recognised by SIM900::findResultCode(), most frequent first.
+static const SIM900ResultCode SIM900_RESULT_CODES[] PROGMEM = {
+    {SIM900_RESULT_OK, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_OK, false},
+    {SIM900_RESULT_ERROR, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_CME_ERROR, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_ERROR, true},
+    {SIM900_RESULT_CMS_ERROR, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_ERROR, true},
+    {SIM900_RESULT_SEND_OK, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_CONNECT_OK, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_ALREADY_CONNECT, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_CLOSE_OK, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_SHUT_OK, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_DOWNLOAD, SIM900_COMMAND_OK, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_NO_CARRIER, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_NO_CARRIER, false},
+    {SIM900_RESULT_NO_DIALTONE, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_NO_DIALTONE, false},
+    {SIM900_RESULT_NO_ANSWER, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_NO_ANSWER, false},
+    {SIM900_RESULT_BUSY, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_BUSY, false},
+    {SIM900_RESULT_CONNECT_FAIL, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_ERROR, false},
+    {SIM900_RESULT_SEND_FAIL, SIM900_COMMAND_ERROR, SIM900_DIAL_RESULT_ERROR, false}
+};
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::sendCommand(String message) {
+    this->await();
+    this->startCommand(message, NULL);
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::startCommand(String message, Completion handler, uint32_t timeout) {
+    if(this->isBusy())
+        return false;
+
+    this->nameCommand(message.c_str(), false);
+    this->countSent(message.length() + 2);
+
+    this->armCommand(handler, timeout);
+    this->sim900.println(message);
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::nameCommand(const char* message, bool flash) {
+    uint8_t length = 0;
+    bool extended = flash ?
+        strncmp_P("AT+", message, 3) == 0 :
+        strncmp(message, "AT+", 3) == 0;
+
+    if(extended)
+        for(uint16_t i = 2; length < sizeof(this->commandName) - 1; i++) {
+            char ch = flash ? (char) pgm_read_byte(message + i) : message[i];
+            if(ch == '\0' || ch == '=' || ch == '?' || ch == ';')
+                break;
+
+            this->commandName[length++] = ch;
+        }
+    this->commandName[length] = '\0';
+
+    this->promptExpected = strcmp_P(this->commandName, PSTR("+CMGS")) == 0 ||
+        strncmp_P(this->commandName, PSTR("+CIPSEND"), sizeof(this->commandName) - 1) == 0;
+    this->addressExpected = strcmp_P(this->commandName, PSTR("+CIFSR")) == 0;
+
+#ifdef SIM900_ENABLE_STATS
+    this->statsFamily = this->statsFamilyOf(this->commandName);
+#endif
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::countSent(size_t length) {
+#ifdef SIM900_ENABLE_STATS
+    this->statistics.families[this->statsFamily].bytes_sent += length;
+#else
+    (void) length;
+#endif
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::armCommand(Completion handler, uint32_t timeout) {
+    this->responseBuffer[0] = '\0';
+    this->responseLength = this->lineStart = this->resultStart = 0;
+    this->echoPending = true;
+    this->urcContinued = false;
+    this->textPending = false;
+    this->lineBlank = false;
+    this->responseHeld = false;
+    this->completion = handler;
+    this->lineHandler = NULL;
+    this->commandTimeout = timeout;
+    this->commandStatus = SIM900_COMMAND_PENDING;
+    this->commandStart = millis();
+
+#ifdef SIM900_ENABLE_STATS
+    this->statsStart = this->commandStart;
+    this->statsReceived = this->bytesReceived;
+#endif
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::finishCommand(SIM900CommandStatus status) {
+#ifdef SIM900_ENABLE_STATS
+    this->recordStats(status);
+#endif
+
+    this->commandStatus = status;
+    this->resultStart = this->lineStart;
+    this->urcContinued = false;
+    this->promptExpected = false;
+    this->addressExpected = false;
+    this->responseHeld = true;
+
+    Completion handler = this->completion;
+    this->completion = NULL;
+    this->lineHandler = NULL;
+
+    if(handler != NULL)
+        (this->*handler)(status);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::await() {
+    while(this->isBusy())
+        if(!this->poll())
+            yield();
+}
+
+template<class Transport, uint16_t RxBufSize>
+int8_t BasicSIM900<Transport, RxBufSize>::findResultCode(const char* line) {
+    line = this->stripLink(line);
+
+    for(uint8_t i = 0; i < sizeof(SIM900_RESULT_CODES) / sizeof(SIM900_RESULT_CODES[0]); i++) {
+        const char* code = (const char*) pgm_read_ptr(&SIM900_RESULT_CODES[i].code);
+
+        if(pgm_read_byte(&SIM900_RESULT_CODES[i].match_prefix) ?
+            strncmp_P(line, code, strlen_P(code)) == 0 :
+            strcmp_P(line, code) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CommandStatus BasicSIM900<Transport, RxBufSize>::finalResult(const char* line) {
+    int8_t code = this->findResultCode(line);
+    if(code < 0)
+        return SIM900_COMMAND_PENDING;
+
+    return (SIM900CommandStatus) pgm_read_byte(&SIM900_RESULT_CODES[code].status);
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900DialResult BasicSIM900<Transport, RxBufSize>::dialResult() {
+    int8_t code = this->findResultCode(this->getReturnedMode());
+    if(code < 0)
+        return SIM900_DIAL_RESULT_ERROR;
+
+    return (SIM900DialResult) pgm_read_byte(&SIM900_RESULT_CODES[code].dial);
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CommandStatus BasicSIM900<Transport, RxBufSize>::receive(char ch) {
+    if(ch == '\r')
+        return SIM900_COMMAND_PENDING;
+
+    if(this->responseHeld && !this->isBusy()) {
+        this->responseHeld = false;
+        this->responseLength = this->lineStart = 0;
+        this->responseBuffer[0] = '\0';
+    }
+
+    if(ch == '\n')
+        return this->receiveLine(this->responseBuffer + this->lineStart);
+
+    if(this->responseLength < RxBufSize - 1) {
+        this->responseBuffer[this->responseLength++] = ch;
+        this->responseBuffer[this->responseLength] = '\0';
+    }
+
+    if(ch == '>' && this->promptExpected && this->responseLength - this->lineStart == 1) {
+        this->promptExpected = false;
+        return SIM900_COMMAND_PROMPT;
+    }
+
+    return SIM900_COMMAND_PENDING;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CommandStatus BasicSIM900<Transport, RxBufSize>::receiveLine(char* line) {
+    if(*line == '\0') {
+        this->lineBlank = true;
+        return SIM900_COMMAND_PENDING;
+    }
+
+    bool blank = this->lineBlank;
+    this->lineBlank = false;
+
+    if(this->urcContinued) {
+        this->urcContinued = false;
+        this->lineStart = this->urcStart;
+
+        this->dispatchURC(this->responseBuffer + this->urcStart);
+        this->dropLine();
+
+        return SIM900_COMMAND_PENDING;
+    }
+
+    if(this->textPending && blank)
+        this->textPending = false;
+
+    if(this->textPending && this->lineHandler != NULL && this->isBusy()) {
+        (this->*lineHandler)(line);
+        this->dropLine();
+
+        this->commandStart = millis();
+        return SIM900_COMMAND_PENDING;
+    }
+
+    if(this->isURC(line)) {
+        if(strncmp_P(line, SIM900_URC_CMT, strlen_P(SIM900_URC_CMT)) == 0 &&
+            this->responseLength < RxBufSize - 1) {
+            this->urcContinued = true;
+            this->urcStart = this->lineStart;
+
+            this->responseBuffer[this->responseLength++] = '\n';
+            this->responseBuffer[this->responseLength] = '\0';
+            this->lineStart = this->responseLength;
+
+            return SIM900_COMMAND_PENDING;
+        }
+
+        this->dispatchURC(line);
+        this->dropLine();
+
+        return SIM900_COMMAND_PENDING;
+    }
+
+    if(!this->isBusy()) {
+        this->dropLine();
+        return SIM900_COMMAND_PENDING;
+    }
+
+    if(this->echoPending) {
+        this->echoPending = false;
+
+        if(strncmp_P(line, PSTR("AT"), 2) == 0) {
+            this->dropLine();
+            return SIM900_COMMAND_PENDING;
+        }
+    }
+
+    SIM900CommandStatus status = this->finalResult(line);
+    if(status != SIM900_COMMAND_PENDING)
+        return status;
+
+    if(this->addressExpected && this->isAddress(line))
+        return SIM900_COMMAND_OK;
+
+    if(this->lineHandler != NULL) {
+        (this->*lineHandler)(line);
+        this->dropLine();
+
+        this->commandStart = millis();
+        return SIM900_COMMAND_PENDING;
+    }
+
+    uint16_t limit = RxBufSize - 1 - SIM900_RESULT_RESERVE;
+    if(this->responseLength >= limit)
+        this->responseLength = limit - 1;
+
+    if(this->responseLength > this->lineStart)
+        this->responseBuffer[this->responseLength++] = '\n';
+    else this->responseLength = this->lineStart;
+
+    this->responseBuffer[this->responseLength] = '\0';
+    this->lineStart = this->responseLength;
+
+    return SIM900_COMMAND_PENDING;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::dropLine() {
+    this->responseLength = this->lineStart;
+    this->responseBuffer[this->responseLength] = '\0';
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::isURC(const char* line) {
+    uint8_t length = strlen(this->commandName);
+    if(this->isBusy() && length > 0 &&
+        strncmp(line, this->commandName, length) == 0 &&
+        line[length] == ':')
+        return false;
+
+    for(uint8_t i = 0; i < SIM900_MAX_URC_HANDLERS; i++)
+        if(this->urcHandlers[i].prefix != NULL &&
+            strncmp(
+                line,
+                this->urcHandlers[i].prefix,
+                strlen(this->urcHandlers[i].prefix)
+            ) == 0)
+            return true;
+
+    const char* event = this->stripLink(line);
+    for(uint8_t i = 0; i < sizeof(SIM900_URCS) / sizeof(SIM900_URCS[0]); i++) {
+        const char* prefix = (const char*) pgm_read_ptr(&SIM900_URCS[i]);
+
+        if(strncmp_P(event, prefix, strlen_P(prefix)) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::isAddress(const char* line) {
+    uint8_t dots = 0, digits = 0;
+
+    for(; *line != '\0'; line++) {
+        if(*line >= '0' && *line <= '9' && digits < 3)
+            digits++;
+        else if(*line == '.' && digits > 0 && dots < 3) {
+            dots++;
+            digits = 0;
+        }
+        else return false;
+    }
+
+    return dots == 3 && digits > 0;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::dispatchURC(const char* urc) {
+    this->trackURC(urc);
+
+    for(uint8_t i = 0; i < SIM900_MAX_URC_HANDLERS; i++)
+        if(this->urcHandlers[i].prefix != NULL &&
+            strncmp(
+                urc,
+                this->urcHandlers[i].prefix,
+                strlen(this->urcHandlers[i].prefix)
+            ) == 0)
+            this->urcHandlers[i].callback(urc);
+}
+
+template<class Transport, uint16_t RxBufSize>
+const char* BasicSIM900<Transport, RxBufSize>::stripLink(const char* line) {
+    if(line[0] >= '0' && line[0] <= '9' &&
+        line[1] == ',' && line[2] == ' ')
+        return line + 3;
+
+    return line;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::trackURC(const char* urc) {
+    const char* event = this->stripLink(urc);
+    uint8_t link = event == urc ? 0 : urc[0] - '0';
+
+    if(strcmp_P(event, SIM900_URC_CLOSED) == 0) {
+        if(link < SIM900_MAX_CONNECTIONS)
+            this->connections[link].state = SIM900_CONNECTION_CLOSED;
+    }
+    else if(strncmp_P(event, SIM900_URC_PDP_DEACT, strlen_P(SIM900_URC_PDP_DEACT)) == 0) {
+        for(uint8_t i = 0; i < SIM900_MAX_CONNECTIONS; i++)
+            this->connections[i].state = SIM900_CONNECTION_CLOSED;
+
+        this->bearerOpen = false;
+    }
+    else if(strcmp_P(event, SIM900_URC_RDY) == 0) {
+        this->invalidateSettings();
+        this->readyFlags = SIM900_READY_BOOTED;
+    }
+    else if(strcmp_P(event, SIM900_URC_POWER_DOWN) == 0) {
+        this->invalidateSettings();
+        this->readyFlags = 0;
+    }
+    else if(strcmp_P(event, PSTR("+CFUN: 1")) == 0)
+        this->markReady(SIM900_READY_FUNCTIONAL);
+    else if(strcmp_P(event, PSTR("+CPIN: READY")) == 0)
+        this->markReady(SIM900_READY_SIM);
+    else if(strcmp_P(event, SIM900_URC_CALL_READY) == 0)
+        this->markReady(SIM900_READY_CALL);
+    else if(strcmp_P(event, SIM900_URC_SMS_READY) == 0)
+        this->markReady(SIM900_READY_SMS);
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::onURC(const char* prefix, SIM900URCCallback callback) {
+    SIM900URCHandler* free = NULL;
+
+    for(uint8_t i = 0; i < SIM900_MAX_URC_HANDLERS; i++) {
+        SIM900URCHandler* handler = &this->urcHandlers[i];
+
+        if(handler->prefix != NULL && strcmp(handler->prefix, prefix) == 0) {
+            handler->callback = callback;
+            if(callback == NULL)
+                handler->prefix = NULL;
+
+            return true;
+        }
+
+        if(handler->prefix == NULL && free == NULL)
+            free = handler;
+    }
+
+    if(callback == NULL)
+        return true;
+
+    if(free == NULL)
+        return false;
+
+    free->prefix = prefix;
+    free->callback = callback;
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::poll() {
+    while(this->transportAvailable() > 0) {
+        this->bytesReceived++;
+        SIM900CommandStatus status = this->receive((char) this->transportRead());
+
+        if(this->isBusy() && status != SIM900_COMMAND_PENDING) {
+            this->finishCommand(status);
+            return true;
+        }
+    }
+
+    if(!this->isBusy())
+        return false;
+
+    if(millis() - this->commandStart >= this->commandTimeout) {
+        this->finishCommand(SIM900_COMMAND_TIMEOUT);
+        return true;
+    }
+
+    return false;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::isBusy() {
+    return this->commandStatus == SIM900_COMMAND_PENDING;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CommandStatus BasicSIM900<Transport, RxBufSize>::status() {
+    return this->commandStatus;
+}
+
+template<class Transport, uint16_t RxBufSize>
+char* BasicSIM900<Transport, RxBufSize>::lastResponse() {
+    return this->responseBuffer;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::submit(String command, CommandCallback callback, uint32_t timeout) {
+    if(!this->startCommand(command, &BasicSIM900::completeCommand, timeout))
+        return false;
+
+    this->callback.command = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeCommand(SIM900CommandStatus status) {
+    if(this->callback.command != NULL)
+        this->callback.command(*this, status);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeResult(SIM900CommandStatus status) {
+    if(this->callback.result != NULL)
+        this->callback.result(status == SIM900_COMMAND_OK);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeSignal(SIM900CommandStatus status) {
+    bool success = status == SIM900_COMMAND_OK;
+
+    if(this->callback.signal != NULL)
+        this->callback.signal(
+            success,
+            this->parseSignal(success ? this->queryResult(this->responseBuffer) : NULL)
+        );
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeOperator(SIM900CommandStatus status) {
+    bool success = status == SIM900_COMMAND_OK;
+
+    if(this->callback.networkOperator != NULL)
+        this->callback.networkOperator(
+            success,
+            this->parseOperator(success ? this->queryResult(this->responseBuffer) : NULL)
+        );
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completePhonebookCapacity(SIM900CommandStatus status) {
+    bool success = status == SIM900_COMMAND_OK;
+
+    if(this->callback.phonebookCapacity != NULL)
+        this->callback.phonebookCapacity(
+            success,
+            this->parsePhonebookCapacity(success ? this->queryResult(this->responseBuffer) : NULL)
+        );
+}
+
+template<class Transport, uint16_t RxBufSize>
+char* BasicSIM900<Transport, RxBufSize>::getResponse(uint32_t timeout) {
+    if(this->isBusy()) {
+        this->commandTimeout = timeout;
+        this->await();
+    }
+
+    return this->responseBuffer;
+}
+
+template<class Transport, uint16_t RxBufSize>
+const char* BasicSIM900<Transport, RxBufSize>::getReturnedMode(uint32_t timeout) {
+    this->getResponse(timeout);
+    return this->responseBuffer + this->resultStart;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::isSuccessCommand(uint32_t timeout) {
+    return strcmp_P(this->getReturnedMode(timeout), PSTR("OK")) == 0;
+}
+
+template<class Transport, uint16_t RxBufSize>
+char* BasicSIM900<Transport, RxBufSize>::rawQueryOnLine(uint16_t line) {
+    char* result = this->getResponse();
+
+    for(; line > 0 && result != NULL; line--) {
+        result = strchr(result, '\n');
+
+        if(result != NULL)
+            result++;
+    }
+
+    if(result == NULL)
+        return this->responseBuffer + this->responseLength;
+
+    char* end = strchr(result, '\n');
+    if(end != NULL)
+        *end = '\0';
+
+    return result;
+}
+
+template<class Transport, uint16_t RxBufSize>
+char* BasicSIM900<Transport, RxBufSize>::queryResult() {
+    return this->queryResult(this->getResponse());
+}
+
+template<class Transport, uint16_t RxBufSize>
+char* BasicSIM900<Transport, RxBufSize>::queryResult(char* response) {
+    char* result = strstr(response, ": ");
+    if(result == NULL)
+        return NULL;
+
+    result += 2;
+
+    char* end = strchr(result, '\n');
+    if(end != NULL)
+        *end = '\0';
+
+    return result;
+}
+
+template<class Transport, uint16_t RxBufSize>
+BasicSIM900<Transport, RxBufSize>::BasicSIM900(Transport& _sim900):sim900(_sim900) {
+    this->callback.command = NULL;
+    this->commandName[0] = '\0';
+
+#ifdef SIM900_ENABLE_STATS
+    this->resetStats();
+#endif
+
+    for(uint8_t i = 0; i < SIM900_MAX_URC_HANDLERS; i++) {
+        this->urcHandlers[i].prefix = NULL;
+        this->urcHandlers[i].callback = NULL;
+    }
+
+    for(uint8_t i = 0; i < SIM900_MAX_CONNECTIONS; i++) {
+        this->connections[i].port = 0;
+        this->connections[i].state = SIM900_CONNECTION_CLOSED;
+        this->connections[i].lastUsed = 0;
+    }
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::begin(uint8_t readiness, int8_t powerPin, uint32_t timeout) {
+    uint32_t start = millis();
+    uint32_t quietSince = start - SIM900_RESPONSE_TIMEOUT;
+
+    if(powerPin >= 0 && !this->handshake()) {
+        this->readyFlags = 0;
+
+        pinMode(powerPin, OUTPUT);
+        digitalWrite(powerPin, HIGH);
+        delay(SIM900_POWER_PULSE);
+        digitalWrite(powerPin, LOW);
+
+        quietSince = millis();
+    }
+
+    uint32_t received = this->bytesReceived;
+
+    while((this->readyFlags & readiness) != readiness) {
+        if(millis() - start >= timeout)
+            return false;
+
+        this->poll();
+        if(this->bytesReceived != received) {
+            received = this->bytesReceived;
+            quietSince = millis();
+        }
+        else if(millis() - quietSince >= SIM900_RESPONSE_TIMEOUT) {
+            this->probeReadiness();
+
+            received = this->bytesReceived;
+            quietSince = millis();
+        }
+        else yield();
+    }
+
+    this->readyTime = millis() - start;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint8_t BasicSIM900<Transport, RxBufSize>::readiness() {
+    return this->readyFlags;
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint32_t BasicSIM900<Transport, RxBufSize>::timeToReady() {
+    return this->readyTime;
+}
+
+#ifdef SIM900_ENABLE_STATS
+/// Upper bounds in milliseconds of the round-trip time histogram buckets, the last bucket being unbounded.
+static const uint16_t SIM900_STATS_BOUNDS[SIM900_STATS_BUCKETS - 1] PROGMEM = {
+    50, 100, 200, 500, 1000, 2000, 5000
+};
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::statsSnapshot(SIM900Stats& snapshot) {
+    snapshot = this->statistics;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::resetStats() {
+    memset(&this->statistics, 0, sizeof(this->statistics));
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint8_t BasicSIM900<Transport, RxBufSize>::statsFamilyOf(const char* name) {
+    for(uint8_t i = 0; i < this->statistics.family_count; i++)
+        if(strcmp(this->statistics.families[i].name, name) == 0)
+            return i;
+
+    if(this->statistics.family_count >= SIM900_STATS_FAMILIES - 1 && name[0] != '\0')
+        return this->statsFamilyOf("");
+
+    SIM900CommandStats& family = this->statistics.families[this->statistics.family_count];
+    memset(&family, 0, sizeof(family));
+    strncpy(family.name, name, sizeof(family.name) - 1);
+
+    return this->statistics.family_count++;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::recordStats(SIM900CommandStatus status) {
+    if(this->statsFamily >= this->statistics.family_count)
+        return;
+
+    SIM900CommandStats& family = this->statistics.families[this->statsFamily];
+    uint32_t elapsed = millis() - this->statsStart;
+
+    family.calls++;
+    family.total_time += elapsed;
+    family.bytes_received += this->bytesReceived - this->statsReceived;
+
+    if(family.calls == 1 || elapsed < family.min_time)
+        family.min_time = elapsed;
+    if(elapsed > family.max_time)
+        family.max_time = elapsed;
+
+    if(status == SIM900_COMMAND_TIMEOUT)
+        family.timeouts++;
+    else if(status == SIM900_COMMAND_ERROR)
+        family.errors++;
+
+    uint8_t bucket = 0;
+    while(bucket < SIM900_STATS_BUCKETS - 1 &&
+        elapsed >= pgm_read_word(&SIM900_STATS_BOUNDS[bucket]))
+        bucket++;
+
+    this->statistics.histogram[bucket]++;
+    this->statsReceived = this->bytesReceived;
+}
+#endif
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::markReady(uint8_t stage) {
+    this->readyFlags |= stage | (stage - 1);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::probeReadiness() {
+    if(!this->handshake())
+        return;
+    this->markReady(SIM900_READY_BOOTED);
+
+    this->sendCommand(F("AT+CFUN?"));
+    char* result = this->queryResult();
+
+    if(result == NULL || strcmp_P(result, PSTR("1")) != 0)
+        return;
+    this->markReady(SIM900_READY_FUNCTIONAL);
+
+    this->sendCommand(F("AT+CPIN?"));
+    result = this->queryResult();
+
+    if(result == NULL || strcmp_P(result, PSTR("READY")) != 0)
+        return;
+    this->markReady(SIM900_READY_SIM);
+
+    this->sendCommand(F("AT+CCALR?"));
+    result = this->queryResult();
+
+    if(result == NULL || strcmp_P(result, PSTR("1")) != 0)
+        return;
+    this->markReady(SIM900_READY_CALL);
+
+    this->sendCommand(F("AT+CPMS?"));
+    if(this->isSuccessCommand())
+        this->markReady(SIM900_READY_SMS);
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::handshake() {
+    this->sendCommand(F("AT"));
+    return this->isSuccessCommand();
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::setEcho(bool enabled) {
+    return this->applySetting(this->echoMode, enabled ? 1 : 0, F("ATE"));
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint32_t BasicSIM900<Transport, RxBufSize>::detectBaudRate(SIM900BaudCallback reopen) {
+    this->await();
+
+    for(uint8_t i = 0; i < sizeof(SIM900_BAUD_RATES) / sizeof(SIM900_BAUD_RATES[0]); i++) {
+        uint32_t baud = pgm_read_dword(&SIM900_BAUD_RATES[i]);
+        reopen(baud);
+
+        for(uint8_t attempt = 0; attempt < 2; attempt++) {
+            while(this->transportAvailable() > 0)
+                this->transportRead();
+
+            if(this->handshake())
+                return baud;
+        }
+    }
+
+    return 0;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::setBaudRate(uint32_t baud, SIM900BaudCallback reopen, bool persist) {
+    this->sendCommand(F("AT+IPR="), baud);
+    if(!this->isSuccessCommand())
+        return false;
+
+    this->sim900.flush();
+    reopen(baud);
+
+    bool verified = false;
+    for(uint8_t attempt = 0; attempt < 3 && !verified; attempt++)
+        verified = this->handshake();
+
+    if(!verified)
+        return false;
+
+    if(persist) {
+        this->sendCommand(F("AT&W"));
+        return this->isSuccessCommand();
+    }
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint32_t BasicSIM900<Transport, RxBufSize>::measureThroughput(uint8_t rounds) {
+    this->await();
+
+    uint32_t received = this->bytesReceived;
+    uint32_t sent = 0;
+    uint32_t start = millis();
+
+    for(uint8_t i = 0; i < rounds; i++) {
+        this->sendCommand(F("ATI"));
+        sent += 5;
+
+        if(!this->isSuccessCommand())
+            return 0;
+    }
+
+    uint32_t elapsed = millis() - start;
+    if(elapsed == 0)
+        elapsed = 1;
+
+    return (sent + this->bytesReceived - received) * 1000UL / elapsed;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::applySetting(int8_t& shadow, int8_t value, const __FlashStringHelper* command) {
+    if(shadow == value)
+        return true;
+
+    this->sendCommand(command, value);
+    shadow = this->isSuccessCommand() ? value : -1;
+
+    return shadow == value;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::invalidateSettings() {
+    this->messageFormat = this->engineeringMode = this->echoMode = -1;
+    this->multiConnection = false;
+    this->bearerOpen = false;
+
+    for(uint8_t i = 0; i < SIM900_MAX_CONNECTIONS; i++)
+        this->connections[i].state = SIM900_CONNECTION_CLOSED;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::handshake(SIM900ResultCallback callback) {
+    if(!this->startCommand(F("AT"), &BasicSIM900::completeResult))
+        return false;
+
+    this->callback.result = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::isCardReady() {
+    this->sendCommand(F("AT+CPIN?"));
+    return this->isSuccessCommand();
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::changeCardPin(uint8_t pin) {
+    if(pin > 9999)
+        return false;
+
+    this->sendCommand(F("AT+CPIN=\""), pin, '"');
+    return this->isSuccessCommand();
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900Signal BasicSIM900<Transport, RxBufSize>::signal() {
+    this->sendCommand(F("AT+CSQ"));
+    return this->parseSignal(this->queryResult());
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::signal(SIM900SignalCallback callback) {
+    if(!this->startCommand(F("AT+CSQ"), &BasicSIM900::completeSignal))
+        return false;
+
+    this->callback.signal = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900Signal BasicSIM900<Transport, RxBufSize>::parseSignal(char* result) {
+    SIM900Signal signal;
+    signal.rssi = signal.bit_error_rate = 0;
+
+    SIM900Tokenizer tokens(result);
+    signal.rssi = (uint8_t) tokens.nextInt();
+    signal.bit_error_rate = (uint8_t) tokens.nextInt();
+
+    return signal;
+}
+
+// void SIM900::close() {
+//     this->sim900->end();
+// }
+
+template<class Transport, uint16_t RxBufSize>
+SIM900DialResult BasicSIM900<Transport, RxBufSize>::dialUp(String number) {
+    this->sendCommand(F("ATD+ "), number, ';');
+    return this->dialResult();
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900DialResult BasicSIM900<Transport, RxBufSize>::redialUp() {
+    this->sendCommand(F("ATDL"));
+    return this->dialResult();
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900DialResult BasicSIM900<Transport, RxBufSize>::acceptIncomingCall() {
+    this->sendCommand(F("ATA"));
+    return this->dialResult();
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::hangUp() {
+    this->sendCommand(F("ATH"));
+    return this->isSuccessCommand();
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::sendSMS(String number, String message) {
+    this->await();
+    if(!this->sendSMS(number, message, NULL))
+        return false;
+
+    this->await();
+    return this->commandStatus == SIM900_COMMAND_OK;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::sendSMS(String number, String message, SIM900ResultCallback callback) {
+    if(this->isBusy())
+        return false;
+
+    this->sentReference = -1;
+    if(this->messageFormat == 1) {
+        if(!this->startCommand(&BasicSIM900::completeSMSPrompt, SIM900_RESPONSE_TIMEOUT, F("AT+CMGS=\""), number, '"'))
+            return false;
+
+        this->pendingPayload = message;
+    }
+    else {
+        if(!this->startCommand(F("AT+CMGF=1"), &BasicSIM900::completeSMSFormat))
+            return false;
+
+        this->pendingPayload = number;
+        this->pendingPayload += '\n';
+        this->pendingPayload += message;
+    }
+
+    this->callback.result = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900SMSReport BasicSIM900<Transport, RxBufSize>::sendSMS(SIM900SMS* messages, uint16_t count) {
+    SIM900SMSReport report;
+    report.sent = report.failed = 0;
+    report.per_minute = 0;
+
+    uint32_t start = millis();
+    bool textMode = this->applySetting(this->messageFormat, 1, F("AT+CMGF="));
+
+    for(uint16_t i = 0; i < count; i++) {
+        messages[i].reference = -1;
+        messages[i].sent = textMode && this->sendBatchSMS(messages[i]);
+
+        if(messages[i].sent)
+            report.sent++;
+        else report.failed++;
+    }
+
+    report.elapsed = millis() - start;
+    if(report.elapsed > 0)
+        report.per_minute = (uint16_t) ((uint32_t) report.sent * 60000UL / report.elapsed);
+
+    return report;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::sendBatchSMS(SIM900SMS& sms) {
+    this->sendCommand(F("AT+CMGS=\""), sms.number, '"');
+
+    if(strcmp_P(this->getReturnedMode(), PSTR(">")) != 0) {
+        if(this->commandStatus == SIM900_COMMAND_TIMEOUT)
+            this->sim900.write(0x1b);
+
+        return false;
+    }
+
+    this->sim900.print(sms.message);
+    this->sim900.write(0x1a);
+    this->countSent(sms.message.length() + 1);
+
+    while(this->readRawLine(SIM900_SMS_TIMEOUT)) {
+        if(strncmp_P(this->responseBuffer, PSTR("+CMGS: "), 7) == 0)
+            sms.reference = (int16_t) strtol(this->responseBuffer + 7, NULL, 10);
+        else if(this->isURC(this->responseBuffer))
+            this->dispatchURC(this->responseBuffer);
+        else if(this->finalResult(this->responseBuffer) != SIM900_COMMAND_PENDING)
+            return this->finalResult(this->responseBuffer) == SIM900_COMMAND_OK &&
+                sms.reference != -1;
+    }
+
+    return false;
+}
+
+template<class Transport, uint16_t RxBufSize>
+int16_t BasicSIM900<Transport, RxBufSize>::readSMS(SIM900ReceivedSMSCallback callback, bool unreadOnly, bool drain) {
+    if(!this->applySetting(this->messageFormat, 1, F("AT+CMGF=")))
+        return -1;
+
+    this->await();
+    this->startCommand(
+        unreadOnly ? F("AT+CMGL=\"REC UNREAD\"") : F("AT+CMGL=\"ALL\""),
+        &BasicSIM900::completeSMSList
+    );
+
+    this->callback.receivedSMS = callback;
+    this->lineHandler = &BasicSIM900::receiveSMSListLine;
+    this->receivedPending = false;
+    this->deliveredCount = 0;
+
+    this->await();
+    if(this->commandStatus != SIM900_COMMAND_OK)
+        return -1;
+
+    int16_t count = (int16_t) this->deliveredCount;
+    if(drain && !this->deleteAllSMS(true))
+        return -1;
+
+    return count;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::deleteAllSMS(bool readOnly) {
+    if(!this->applySetting(this->messageFormat, 1, F("AT+CMGF=")))
+        return false;
+
+    this->sendCommand(readOnly ? F("AT+CMGDA=\"DEL READ\"") : F("AT+CMGDA=\"DEL ALL\""));
+    return this->isSuccessCommand(SIM900_SMS_TIMEOUT);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receiveSMSListLine(char* line) {
+    if(strncmp_P(line, PSTR("+CMGL: "), 7) != 0) {
+        if(!this->receivedPending)
+            return;
+
+        if(this->receivedSMS.message.length() > 0)
+            this->receivedSMS.message += '\n';
+
+        this->receivedSMS.message += line;
+        return;
+    }
+
+    this->deliverReceivedSMS();
+
+    SIM900Tokenizer fields(line + 7);
+    this->receivedSMS.index = (uint16_t) fields.nextInt();
+    this->receivedSMS.status = fields.next();
+    this->receivedSMS.number = fields.next();
+
+    fields.next();
+    this->receivedSMS.timestamp = this->parseTimestamp(fields.next());
+    this->receivedSMS.message = F("");
+
+    this->receivedPending = true;
+    this->textPending = true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeSMSList(SIM900CommandStatus status) {
+    if(status == SIM900_COMMAND_OK)
+        this->deliverReceivedSMS();
+
+    this->receivedPending = false;
+    this->receivedSMS.status = this->receivedSMS.number =
+        this->receivedSMS.message = F("");
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::deliverReceivedSMS() {
+    if(!this->receivedPending)
+        return;
+
+    this->receivedPending = false;
+    this->deliveredCount++;
+
+    if(this->callback.receivedSMS != NULL)
+        this->callback.receivedSMS(this->receivedSMS);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeSMSFormat(SIM900CommandStatus status) {
+    this->messageFormat = status == SIM900_COMMAND_OK ? 1 : -1;
+
+    if(status != SIM900_COMMAND_OK) {
+        this->pendingPayload = F("");
+        this->completeResult(status);
+
+        return;
+    }
+
+    int delim = this->pendingPayload.indexOf('\n');
+    this->startCommand(
+        &BasicSIM900::completeSMSPrompt,
+        SIM900_RESPONSE_TIMEOUT,
+        F("AT+CMGS=\""), this->pendingPayload.substring(0, delim), '"'
+    );
+    this->pendingPayload = this->pendingPayload.substring(delim + 1);
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeSMSPrompt(SIM900CommandStatus status) {
+    if(status != SIM900_COMMAND_PROMPT) {
+        if(status == SIM900_COMMAND_TIMEOUT || status == SIM900_COMMAND_ERROR)
+            this->sim900.write(0x1b);
+
+        this->pendingPayload = F("");
+        this->completeResult(status);
+
+        return;
+    }
+
+    this->armCommand(&BasicSIM900::completeResult, SIM900_SMS_TIMEOUT);
+    this->lineHandler = &BasicSIM900::receiveSMSSentLine;
+
+    this->sim900.print(this->pendingPayload);
+    this->sim900.write(0x1a);
+    this->countSent(this->pendingPayload.length() + 1);
+    this->pendingPayload = F("");
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receiveSMSSentLine(char* line) {
+    if(strncmp_P(line, PSTR("+CMGS: "), 7) == 0)
+        this->sentReference = (int16_t) strtol(line + 7, NULL, 10);
+}
+
+template<class Transport, uint16_t RxBufSize>
+int16_t BasicSIM900<Transport, RxBufSize>::smsReference() {
+    return this->sentReference;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900Operator BasicSIM900<Transport, RxBufSize>::networkOperator() {
+    this->sendCommand(F("AT+COPS?"));
+    return this->parseOperator(this->queryResult());
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::networkOperator(SIM900OperatorCallback callback) {
+    if(!this->startCommand(F("AT+COPS?"), &BasicSIM900::completeOperator))
+        return false;
+
+    this->callback.networkOperator = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900Operator BasicSIM900<Transport, RxBufSize>::parseOperator(char* result) {
+    SIM900Operator simOperator;
+    simOperator.mode = static_cast<SIM900OperatorMode>(0);
+    simOperator.format = static_cast<SIM900OperatorFormat>(0);
+    simOperator.name = "";
+
+    SIM900Tokenizer tokens(result);
+    simOperator.mode = intToSIM900OperatorMode((uint8_t) tokens.nextInt());
+    simOperator.format = intToSIM900OperatorFormat((uint8_t) tokens.nextInt());
+
+    char* name = tokens.next();
+    if(name != NULL)
+        simOperator.name = name;
+
+    return simOperator;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::connectAPN(const SIM900APN& apn) {
+    if(!this->applySetting(this->messageFormat, 1, F("AT+CMGF=")))
+        return false;
+
+    this->sendCommand(F("AT+CGATT=1"));
+    if(!this->isSuccessCommand())
+        return false;
+    
+    this->sendCommand(
+        F("AT+CSTT=\""), apn.apn,
+        F("\",\""), apn.username,
+        F("\",\""), apn.password, '"'
+    );
+
+    this->apn = apn;
+    this->bearerOpen = false;
+
+    return (this->hasAPN = this->isSuccessCommand());
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::enableGPRS() {
+    if(!this->hasAPN)
+        return false;
+
+    this->sendCommand(F("AT+CIICR"));
+    return this->isSuccessCommand(SIM900_GPRS_TIMEOUT);
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::enableGPRS(SIM900ResultCallback callback) {
+    if(!this->hasAPN ||
+        !this->startCommand(F("AT+CIICR"), &BasicSIM900::completeResult, SIM900_GPRS_TIMEOUT))
+        return false;
+
+    this->callback.result = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::enableConnectionPool() {
+    if(this->multiConnection)
+        return true;
+
+    this->sendCommand(F("AT+CIPMUX=1"));
+    return (this->multiConnection = this->isSuccessCommand());
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::refreshConnections() {
+    this->sendCommand(F("AT+CIPSTATUS"));
+    if(!this->isSuccessCommand())
+        return false;
+
+    while(this->readRawLine(SIM900_RESPONSE_TIMEOUT)) {
+        if(!this->multiConnection) {
+            if(strncmp_P(this->responseBuffer, PSTR("STATE: "), 7) != 0)
+                continue;
+
+            const char* state = this->responseBuffer + 7;
+            if(strcmp_P(state, PSTR("CONNECT OK")) == 0)
+                this->connections[0].state = SIM900_CONNECTION_CONNECTED;
+            else if(strcmp_P(state, PSTR("TCP CONNECTING")) == 0)
+                this->connections[0].state = SIM900_CONNECTION_CONNECTING;
+            else if(strcmp_P(state, PSTR("TCP CLOSING")) == 0)
+                this->connections[0].state = SIM900_CONNECTION_CLOSING;
+            else this->connections[0].state = SIM900_CONNECTION_CLOSED;
+
+            break;
+        }
+
+        if(strncmp_P(this->responseBuffer, PSTR("C: "), 3) != 0)
+            continue;
+
+        SIM900Tokenizer fields(this->responseBuffer + 3);
+        uint8_t link = (uint8_t) fields.nextInt();
+        for(uint8_t i = 0; i < 4; i++)
+            fields.next();
+
+        char* state = fields.next();
+        if(link < SIM900_MAX_CONNECTIONS && state != NULL) {
+            if(strcmp_P(state, PSTR("CONNECTED")) == 0)
+                this->connections[link].state = SIM900_CONNECTION_CONNECTED;
+            else if(strcmp_P(state, PSTR("CONNECTING")) == 0)
+                this->connections[link].state = SIM900_CONNECTION_CONNECTING;
+            else if(strcmp_P(state, PSTR("CLOSING")) == 0 ||
+                strcmp_P(state, PSTR("REMOTE CLOSING")) == 0)
+                this->connections[link].state = SIM900_CONNECTION_CLOSING;
+            else this->connections[link].state = SIM900_CONNECTION_CLOSED;
+        }
+
+        if(link == 7)
+            break;
+    }
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900ConnectionState BasicSIM900<Transport, RxBufSize>::connectionState(uint8_t link) {
+    if(link >= SIM900_MAX_CONNECTIONS)
+        return SIM900_CONNECTION_CLOSED;
+
+    return this->connections[link].state;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::closeConnections() {
+    for(uint8_t i = 0; i < SIM900_MAX_CONNECTIONS; i++)
+        if(this->connections[i].state != SIM900_CONNECTION_CLOSED)
+            this->closeConnection(i);
+}
+
+template<class Transport, uint16_t RxBufSize>
+int8_t BasicSIM900<Transport, RxBufSize>::openConnection(const char* domain, uint16_t port, bool& reused) {
+    int8_t link = -1;
+    reused = false;
+
+    if(this->multiConnection) {
+        for(uint8_t i = 0; i < SIM900_MAX_CONNECTIONS; i++) {
+            SIM900Connection& connection = this->connections[i];
+
+            if(connection.state == SIM900_CONNECTION_CONNECTED &&
+                connection.port == port &&
+                connection.domain == domain) {
+                reused = true;
+                return i;
+            }
+
+            if(connection.state == SIM900_CONNECTION_CLOSED && link == -1)
+                link = i;
+        }
+
+        if(link == -1) {
+            link = 0;
+
+            for(uint8_t i = 1; i < SIM900_MAX_CONNECTIONS; i++)
+                if(millis() - this->connections[i].lastUsed >
+                    millis() - this->connections[link].lastUsed)
+                    link = i;
+
+            this->closeConnection(link);
+        }
+    }
+    else link = 0;
+
+    this->connections[link].domain = domain;
+    this->connections[link].port = port;
+    this->connections[link].state = SIM900_CONNECTION_CONNECTING;
+
+    if(this->multiConnection)
+        this->sendCommand(F("AT+CIPSTART="), link, F(",\"TCP\",\""), domain, F("\","), port);
+    else this->sendCommand(F("AT+CIPSTART=\"TCP\",\""), domain, F("\","), port);
+    if(strcmp_P(this->getReturnedMode(), PSTR("OK")) == 0)
+        this->armCommand(NULL, SIM900_CONNECT_TIMEOUT);
+
+    if(strcmp_P(
+        this->stripLink(this->getReturnedMode(SIM900_CONNECT_TIMEOUT)),
+        PSTR("CONNECT OK")
+    ) != 0) {
+        this->connections[link].state = SIM900_CONNECTION_CLOSED;
+        return -1;
+    }
+
+    this->connections[link].state = SIM900_CONNECTION_CONNECTED;
+    this->connections[link].lastUsed = millis();
+
+    return link;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::closeConnection(int8_t link) {
+    if(this->multiConnection)
+        this->sendCommand(F("AT+CIPCLOSE="), link, F(",1"));
+    else this->sendCommand(F("AT+CIPCLOSE=1"));
+
+    this->getReturnedMode();
+    this->connections[link].state = SIM900_CONNECTION_CLOSED;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900HTTPResponse BasicSIM900<Transport, RxBufSize>::request(const SIM900HTTPRequest& request, Stream& body, uint32_t length, SIM900HTTPBodyCallback sink) {
+    this->uploadStream = &body;
+    this->uploadLength = length;
+
+    SIM900HTTPResponse response = this->request(request, sink);
+    this->uploadStream = NULL;
+
+    return response;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900HTTPResponse BasicSIM900<Transport, RxBufSize>::request(const SIM900HTTPRequest& request, SIM900HTTPBodySource body, uint32_t length, SIM900HTTPBodyCallback sink) {
+    this->uploadSource = body;
+    this->uploadLength = length;
+
+    SIM900HTTPResponse response = this->request(request, sink);
+    this->uploadSource = NULL;
+
+    return response;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900HTTPResponse BasicSIM900<Transport, RxBufSize>::request(const SIM900HTTPRequest& request, SIM900HTTPBodyCallback sink) {
+    SIM900HTTPResponse response;
+    response.status = -1;
+    response.headers = this->httpHeaders;
+    response.header_count = 0;
+    response.ttfb = response.elapsed = 0;
+
+    if(!this->hasAPN)
+        return response;
+
+    uint32_t start = millis();
+    if(this->httpEngine == SIM900_HTTP_ENGINE_BUILTIN) {
+        this->builtinHTTPRequest(request, response, sink);
+
+        response.elapsed = millis() - start;
+        return response;
+    }
+
+    for(uint8_t attempt = 0; attempt < 2; attempt++) {
+        bool reused;
+        int8_t link = this->openConnection(request.domain.c_str(), request.port, reused);
+
+        if(link == -1)
+            break;
+
+        if(!this->sendHTTPRequest(link, request)) {
+            this->closeConnection(link);
+
+            if(reused && this->uploadStream == NULL && this->uploadSource == NULL)
+                continue;
+            break;
+        }
+
+        if(!this->receiveHTTPResponse(link, response, sink) || !this->multiConnection)
+            this->closeConnection(link);
+        else this->connections[link].lastUsed = millis();
+
+        break;
+    }
+
+    response.elapsed = millis() - start;
+    return response;
+}
+
+template<class Transport, uint16_t RxBufSize>
+int BasicSIM900<Transport, RxBufSize>::readRaw(uint32_t timeout) {
+    if(this->activeLink == -1)
+        return this->readStream(timeout);
+
+    while(this->frameRemaining == 0) {
+        if(this->connections[this->activeLink].state != SIM900_CONNECTION_CONNECTED)
+            return -1;
+
+        char header[24];
+        uint8_t length = 0;
+
+        for(int ch = this->readStream(timeout); ch != '\n'; ch = this->readStream(timeout)) {
+            if(ch < 0)
+                return -1;
+
+            if(ch != '\r' && length < sizeof(header) - 1)
+                header[length++] = (char) ch;
+        }
+        header[length] = '\0';
+
+        if(strncmp_P(header, PSTR("+RECEIVE,"), 9) == 0) {
+            SIM900Tokenizer fields(header + 9);
+            int8_t link = (int8_t) fields.nextInt();
+            uint16_t size = (uint16_t) fields.nextInt(':');
+
+            if(link == this->activeLink)
+                this->frameRemaining = size;
+            else while(size-- > 0 && this->readStream(timeout) != -1);
+        }
+        else if(this->isURC(header))
+            this->dispatchURC(header);
+    }
+
+    this->frameRemaining--;
+    return this->readStream(timeout);
+}
+
+template<class Transport, uint16_t RxBufSize>
+int BasicSIM900<Transport, RxBufSize>::readStream(uint32_t timeout) {
+    uint32_t start = millis();
+
+    while(this->transportAvailable() <= 0) {
+        if(millis() - start >= timeout)
+            return -1;
+
+        yield();
+    }
+
+    this->bytesReceived++;
+
+#ifdef SIM900_ENABLE_STATS
+    if(!this->isBusy() && this->statsFamily < this->statistics.family_count)
+        this->statistics.families[this->statsFamily].bytes_received++;
+#endif
+
+    return this->transportRead();
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::readRawLine(uint32_t timeout) {
+    uint16_t length = 0;
+
+    for(int ch = this->readRaw(timeout); ch != '\n'; ch = this->readRaw(timeout)) {
+        if(ch < 0)
+            return false;
+
+        if(ch != '\r' && length < RxBufSize - 1)
+            this->responseBuffer[length++] = (char) ch;
+    }
+
+    this->responseBuffer[length] = '\0';
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+size_t BasicSIM900<Transport, RxBufSize>::printHTTPRequest(Print& out, const SIM900HTTPRequest& request, bool keepAlive) {
+    size_t length = out.print(request.method);
+    length += out.print(' ');
+    length += out.print(request.resource);
+    length += out.print(keepAlive ? F(" HTTP/1.1\r\nHost: ") : F(" HTTP/1.0\r\nHost: "));
+    length += out.print(request.domain);
+    length += out.print(F("\r\n"));
+
+    if(keepAlive)
+        length += out.print(F("Connection: keep-alive\r\n"));
+
+    for(int i = 0; i < request.header_count; i++) {
+        length += out.print(request.headers[i].key);
+        length += out.print(F(": "));
+        length += out.print(request.headers[i].value);
+        length += out.print(F("\r\n"));
+    }
+
+    bool streamed = this->uploadStream != NULL || this->uploadSource != NULL;
+    if(streamed || request.data.length() > 0) {
+        length += out.print(F("Content-Length: "));
+
+        if(streamed)
+            length += out.print(this->uploadLength);
+        else length += out.print(request.data.length());
+
+        length += out.print(F("\r\n"));
+    }
+
+    length += out.print(F("\r\n"));
+    if(!streamed)
+        length += out.print(request.data);
+
+    return length;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::sendHTTPRequest(int8_t link, const SIM900HTTPRequest& request) {
+    SIM900LengthCounter counter;
+    uint32_t head = this->printHTTPRequest(counter, request, this->multiConnection);
+    uint32_t total = head + (this->uploadStream != NULL || this->uploadSource != NULL ?
+        this->uploadLength : 0);
+
+    for(uint32_t offset = 0; offset < total;) {
+        uint16_t chunk = (uint16_t) min((uint32_t) SIM900_SEND_MTU, total - offset);
+        uint16_t headPart = offset < head ? (uint16_t) min((uint32_t) chunk, head - offset) : 0;
+
+        if(!this->beginSend(link, chunk))
+            return false;
+
+        if(headPart > 0) {
+            SIM900WindowPrint window(this->sim900, offset, headPart);
+            this->printHTTPRequest(window, request, this->multiConnection);
+        }
+
+        bool complete = this->writeUpload(chunk - headPart);
+        if(!this->endSend() || !complete)
+            return false;
+
+        offset += chunk;
+    }
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::beginSend(int8_t link, uint16_t length) {
+    if(this->multiConnection)
+        this->sendCommand(F("AT+CIPSEND="), link, ',', length);
+    else this->sendCommand(F("AT+CIPSEND="), length);
+    if(strcmp_P(this->getReturnedMode(), PSTR(">")) != 0)
+        return false;
+
+    this->armCommand(NULL, SIM900_HTTP_TIMEOUT);
+
+#ifdef SIM900_ENABLE_STATS
+    this->statistics.families[this->statsFamily].bytes_sent += length;
+#endif
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::endSend() {
+    return strcmp_P(
+        this->stripLink(this->getReturnedMode(SIM900_HTTP_TIMEOUT)),
+        PSTR("SEND OK")
+    ) == 0;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::writeUpload(uint16_t length) {
+    uint8_t buffer[SIM900_HTTP_CHUNK_SIZE];
+    bool complete = true;
+
+    while(length > 0) {
+        uint16_t size = min(length, (uint16_t) sizeof(buffer));
+        uint16_t count = 0;
+
+        if(complete && this->uploadStream != NULL)
+            count = this->uploadStream->readBytes(buffer, size);
+        else if(complete && this->uploadSource != NULL)
+            count = this->uploadSource(buffer, size);
+
+        if(count < size) {
+            memset(buffer + count, 0, size - count);
+            complete = false;
+        }
+
+        this->sim900.write(buffer, size);
+        length -= size;
+    }
+
+    return complete;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::receiveHTTPResponse(int8_t link, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink) {
+    this->activeLink = this->multiConnection ? link : -1;
+    this->frameRemaining = 0;
+
+    bool keepAlive = true;
+    bool complete = this->parseHTTPResponse(response, sink, keepAlive);
+
+    this->activeLink = -1;
+    return complete && keepAlive &&
+        this->connections[link].state == SIM900_CONNECTION_CONNECTED;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::parseHTTPResponse(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, bool& keepAlive) {
+    uint32_t sent = millis();
+    while(this->transportAvailable() <= 0 && millis() - sent < SIM900_HTTP_TIMEOUT)
+        yield();
+    response.ttfb = millis() - sent;
+
+    do {
+        if(!this->readRawLine(SIM900_HTTP_TIMEOUT))
+            return false;
+    } while(this->responseBuffer[0] == '\0');
+
+    SIM900Tokenizer statusLine(this->responseBuffer);
+    statusLine.next(' ');
+    response.status = (uint16_t) statusLine.nextInt(' ');
+
+    int32_t contentLength = -1;
+    bool chunked = false;
+
+    while(this->readRawLine(SIM900_HTTP_TIMEOUT) && this->responseBuffer[0] != '\0') {
+        char* value = strchr(this->responseBuffer, ':');
+        if(value == NULL)
+            continue;
+
+        *value++ = '\0';
+        while(*value == ' ')
+            value++;
+
+        if(strcasecmp_P(this->responseBuffer, PSTR("Content-Length")) == 0)
+            contentLength = strtol(value, NULL, 10);
+        else if(strcasecmp_P(this->responseBuffer, PSTR("Transfer-Encoding")) == 0 &&
+            strcasecmp_P(value, PSTR("chunked")) == 0)
+            chunked = true;
+        else if(strcasecmp_P(this->responseBuffer, PSTR("Connection")) == 0 &&
+            strcasecmp_P(value, PSTR("close")) == 0)
+            keepAlive = false;
+
+        if(response.header_count < SIM900_HTTP_MAX_HEADERS) {
+            this->httpHeaders[response.header_count].key = this->responseBuffer;
+            this->httpHeaders[response.header_count].value = value;
+            response.header_count++;
+        }
+    }
+
+    if(!chunked) {
+        if(contentLength == -1)
+            keepAlive = false;
+
+        return this->receiveHTTPBody(response, sink, contentLength);
+    }
+
+    for(;;) {
+        if(!this->readRawLine(SIM900_HTTP_TIMEOUT))
+            return false;
+
+        int32_t size = strtol(this->responseBuffer, NULL, 16);
+        if(size <= 0)
+            break;
+
+        if(!this->receiveHTTPBody(response, sink, size) ||
+            !this->readRawLine(SIM900_HTTP_TIMEOUT))
+            return false;
+    }
+
+    while(this->readRawLine(SIM900_HTTP_TIMEOUT) && this->responseBuffer[0] != '\0');
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::receiveHTTPBody(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, int32_t length) {
+    static const char closed[] PROGMEM = "\r\nCLOSED\r\n";
+    const uint8_t closedLength = sizeof(closed) - 1;
+
+    uint8_t chunk[SIM900_HTTP_CHUNK_SIZE];
+    uint16_t used = 0;
+    bool untilClosed = length < 0;
+    bool framed = this->activeLink != -1;
+
+    while(untilClosed || length > 0) {
+        int ch = this->readRaw(SIM900_HTTP_TIMEOUT);
+        if(ch < 0)
+            break;
+
+        chunk[used++] = (uint8_t) ch;
+        if(!untilClosed)
+            length--;
+        else if(!framed && used >= closedLength &&
+            memcmp_P(chunk + used - closedLength, closed, closedLength) == 0) {
+            used -= closedLength;
+            break;
+        }
+
+        if(used == sizeof(chunk)) {
+            uint16_t keep = untilClosed && !framed ? closedLength : 0;
+            this->deliverHTTPBody(response, sink, chunk, used - keep);
+
+            memmove(chunk, chunk + used - keep, keep);
+            used = keep;
+        }
+    }
+
+    if(used > 0)
+        this->deliverHTTPBody(response, sink, chunk, used);
+
+    return untilClosed || length == 0;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::setHTTPEngine(SIM900HTTPEngine engine) {
+    this->httpEngine = engine;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::openBearer() {
+    if(this->bearerOpen)
+        return true;
+
+    this->sendCommand(F("AT+SAPBR=2,1"));
+    char* status = this->queryResult(this->rawQueryOnLine(0));
+
+    if(status != NULL && this->isSuccessCommand()) {
+        SIM900Tokenizer fields(status);
+        fields.next();
+
+        if(fields.nextInt() == 1)
+            return (this->bearerOpen = true);
+    }
+
+    this->sendCommand(F("AT+SAPBR=3,1,\"Contype\",\"GPRS\""));
+    if(!this->isSuccessCommand())
+        return false;
+
+    this->sendCommand(F("AT+SAPBR=3,1,\"APN\",\""), this->apn.apn, '"');
+    if(!this->isSuccessCommand())
+        return false;
+
+    if(this->apn.username.length() > 0) {
+        this->sendCommand(F("AT+SAPBR=3,1,\"USER\",\""), this->apn.username, '"');
+        if(!this->isSuccessCommand())
+            return false;
+
+        this->sendCommand(F("AT+SAPBR=3,1,\"PWD\",\""), this->apn.password, '"');
+        if(!this->isSuccessCommand())
+            return false;
+    }
+
+    this->sendCommand(F("AT+SAPBR=1,1"));
+    return (this->bearerOpen = this->isSuccessCommand(SIM900_GPRS_TIMEOUT));
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::builtinHTTPRequest(const SIM900HTTPRequest& request, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink) {
+    uint8_t action;
+    if(strcasecmp_P(request.method.c_str(), PSTR("GET")) == 0)
+        action = 0;
+    else if(strcasecmp_P(request.method.c_str(), PSTR("POST")) == 0)
+        action = 1;
+    else if(strcasecmp_P(request.method.c_str(), PSTR("HEAD")) == 0)
+        action = 2;
+    else return false;
+
+    if(!this->openBearer())
+        return false;
+
+    this->sendCommand(F("AT+HTTPINIT"));
+    if(!this->isSuccessCommand()) {
+        this->sendCommand(F("AT+HTTPTERM"));
+        this->isSuccessCommand();
+
+        this->sendCommand(F("AT+HTTPINIT"));
+        if(!this->isSuccessCommand())
+            return false;
+    }
+
+    String headers;
+    for(int i = 0; i < request.header_count; i++) {
+        if(request.headers[i].key.equalsIgnoreCase(F("Content-Type")))
+            continue;
+
+        if(headers.length() > 0)
+            headers += F("\\r\\n");
+
+        headers += request.headers[i].key;
+        headers += F(": ");
+        headers += request.headers[i].value;
+    }
+
+    bool success = this->setHTTPParameter(F("CID"), F("1")) &&
+        this->setHTTPParameter(F("URL"),
+            F("http://"), request.domain, ':', request.port, request.resource) &&
+        (headers.length() == 0 || this->setHTTPParameter(F("USERDATA"), headers));
+
+    for(int i = 0; success && i < request.header_count; i++)
+        if(request.headers[i].key.equalsIgnoreCase(F("Content-Type")))
+            success = this->setHTTPParameter(F("CONTENT"), request.headers[i].value);
+
+    bool streamed = this->uploadStream != NULL || this->uploadSource != NULL;
+    uint32_t length = streamed ? this->uploadLength : request.data.length();
+
+    if(success && length > 0) {
+        this->sendCommand(F("AT+HTTPDATA="), length, ',', SIM900_HTTP_TIMEOUT);
+        success = strcmp_P(this->getReturnedMode(), PSTR("DOWNLOAD")) == 0;
+
+        if(success) {
+            this->armCommand(NULL, SIM900_HTTP_TIMEOUT);
+
+            if(!streamed)
+                this->sim900.print(request.data);
+            else for(uint32_t remaining = length; remaining > 0;) {
+                uint16_t chunk = (uint16_t) min((uint32_t) SIM900_SEND_MTU, remaining);
+
+                success = this->writeUpload(chunk) && success;
+                remaining -= chunk;
+            }
+
+            this->countSent(length);
+            success = this->isSuccessCommand(SIM900_HTTP_TIMEOUT) && success;
+        }
+    }
+
+    if(success) {
+        this->sendCommand(F("AT+HTTPACTION="), action);
+        success = this->isSuccessCommand();
+    }
+
+    int32_t contentLength = 0;
+    if(success) {
+        uint32_t sent = millis();
+        success = false;
+
+        while(this->readRawLine(SIM900_HTTP_TIMEOUT)) {
+            if(strncmp_P(this->responseBuffer, PSTR("+HTTPACTION:"), 12) != 0) {
+                if(this->isURC(this->responseBuffer))
+                    this->dispatchURC(this->responseBuffer);
+
+                continue;
+            }
+
+            response.ttfb = millis() - sent;
+
+            SIM900Tokenizer fields(this->responseBuffer + 12);
+            fields.nextInt();
+            response.status = (uint16_t) fields.nextInt();
+            contentLength = fields.nextInt();
+
+            success = true;
+            break;
+        }
+    }
+
+    for(uint32_t offset = 0; success && action != 2 && offset < (uint32_t) contentLength;) {
+        int32_t received = this->readHTTPWindow(offset, response, sink);
+
+        success = received > 0;
+        offset += received;
+    }
+
+    this->sendCommand(F("AT+HTTPTERM"));
+    this->isSuccessCommand();
+
+    return success;
+}
+
+template<class Transport, uint16_t RxBufSize>
+int32_t BasicSIM900<Transport, RxBufSize>::readHTTPWindow(uint32_t offset, SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink) {
+    this->sendCommand(F("AT+HTTPREAD="), offset, ',', SIM900_HTTP_READ_SIZE);
+
+    int32_t length = -1;
+    while(this->readRawLine(SIM900_HTTP_TIMEOUT)) {
+        if(strncmp_P(this->responseBuffer, PSTR("+HTTPREAD:"), 10) == 0) {
+            length = strtol(this->responseBuffer + 10, NULL, 10);
+            break;
+        }
+
+        if(this->finalResult(this->responseBuffer) != SIM900_COMMAND_PENDING)
+            break;
+    }
+
+    if(length >= 0 && !this->receiveHTTPBody(response, sink, length))
+        length = -1;
+
+    while(length >= 0 && this->readRawLine(SIM900_HTTP_TIMEOUT))
+        if(this->finalResult(this->responseBuffer) != SIM900_COMMAND_PENDING)
+            break;
+
+    this->finishCommand(length >= 0 ? SIM900_COMMAND_OK : SIM900_COMMAND_ERROR);
+    return length;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::deliverHTTPBody(SIM900HTTPResponse& response, SIM900HTTPBodyCallback sink, const uint8_t* chunk, uint16_t length) {
+    if(sink != NULL) {
+        sink(chunk, length);
+        return;
+    }
+
+    response.data.reserve(response.data.length() + length);
+    for(uint16_t i = 0; i < length; i++)
+        response.data += (char) chunk[i];
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::updateRtc(SIM900RTC config) {
+    this->sendCommand(
+        F("AT+CCLK=\""), SIM900TwoDigits(config.year),
+        '/', SIM900TwoDigits(config.month),
+        '/', SIM900TwoDigits(config.day),
+        ',', SIM900TwoDigits(config.hour),
+        ':', SIM900TwoDigits(config.minute),
+        ':', SIM900TwoDigits(config.second),
+        config.gmt < 0 ? '-' : '+', SIM900TwoDigits((uint8_t) abs(config.gmt)), '"'
+    );
+
+    return this->isSuccessCommand();
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900RTC BasicSIM900<Transport, RxBufSize>::rtc() {
+    SIM900RTC rtc;
+    rtc.year = rtc.month = rtc.day =
+        rtc.hour = rtc.minute = rtc.second = 
+        rtc.gmt = 0;
+
+    if(!this->applySetting(this->messageFormat, 1, F("AT+CMGF=")) ||
+        !this->applySetting(this->engineeringMode, 3, F("AT+CENG=")))
+        return rtc;
+
+    this->sendCommand(F("AT+CCLK?"));
+    return this->parseRtc(this->queryResult());
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900RTC BasicSIM900<Transport, RxBufSize>::parseRtc(char* result) {
+    SIM900Tokenizer tokens(result);
+    return this->parseTimestamp(tokens.next());
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900RTC BasicSIM900<Transport, RxBufSize>::parseTimestamp(char* time) {
+    SIM900RTC rtc;
+    rtc.year = rtc.month = rtc.day =
+        rtc.hour = rtc.minute = rtc.second = 
+        rtc.gmt = 0;
+
+    if(time == NULL)
+        return rtc;
+
+    SIM900Tokenizer fields(time);
+    rtc.year = (uint8_t) fields.nextInt('/');
+    rtc.month = (uint8_t) fields.nextInt('/');
+    rtc.day = (uint8_t) fields.nextInt(',');
+    rtc.hour = (uint8_t) fields.nextInt(':');
+    rtc.minute = (uint8_t) fields.nextInt(':');
+
+    char* zone = fields.next('\0');
+    if(zone != NULL) {
+        rtc.second = (uint8_t) strtol(zone, &zone, 10);
+        rtc.gmt = (int8_t) strtol(zone, NULL, 10);
+    }
+
+    return rtc;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::savePhonebook(uint8_t index, const SIM900CardAccount& account) {
+    this->sendCommand(
+        F("AT+CPBW="), index,
+        F(",\""), account.number,
+        F("\","), account.numberType,
+        F(",\""), account.name, '"'
+    );
+
+    if(!this->isSuccessCommand())
+        return false;
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    this->indexPhonebook(index, account.number.c_str());
+#endif
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CardAccount BasicSIM900<Transport, RxBufSize>::retrievePhonebook(uint8_t index) {
+    this->sendCommand(F("AT+CPBR="), index);
+    return this->parsePhonebookEntry(this->queryResult(), index);
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookReport BasicSIM900<Transport, RxBufSize>::readPhonebook(uint8_t first, uint8_t last, SIM900PhonebookCallback callback) {
+    this->await();
+    this->callback.phonebook = callback;
+    this->pendingAccounts = NULL;
+
+    return this->readPhonebookRange(first, last);
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookReport BasicSIM900<Transport, RxBufSize>::readPhonebook(uint8_t first, uint8_t last, SIM900CardAccount* accounts, uint8_t size) {
+    for(uint8_t i = 0; i < size; i++) {
+        accounts[i].name = accounts[i].number = F("");
+        accounts[i].numberType = static_cast<SIM900PhonebookType>(0);
+    }
+
+    this->await();
+    this->callback.phonebook = NULL;
+    this->pendingAccounts = accounts;
+    this->pendingFirst = first;
+    this->pendingSize = size;
+
+    SIM900PhonebookReport report = this->readPhonebookRange(first, last);
+    this->pendingAccounts = NULL;
+
+    return report;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookReport BasicSIM900<Transport, RxBufSize>::readPhonebookRange(uint8_t first, uint8_t last) {
+    SIM900PhonebookReport report;
+    uint32_t start = millis();
+
+    this->startCommand(NULL, SIM900_PHONEBOOK_TIMEOUT, F("AT+CPBR="), first, ',', last);
+
+    this->lineHandler = &BasicSIM900::receivePhonebookLine;
+    this->deliveredCount = 0;
+    this->await();
+
+    report.success = this->commandStatus == SIM900_COMMAND_OK;
+    report.entries = this->deliveredCount;
+    report.elapsed = millis() - start;
+    report.per_second = report.elapsed > 0 ?
+        (uint16_t) ((uint32_t) report.entries * 1000UL / report.elapsed) : 0;
+
+    return report;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receivePhonebookLine(char* line) {
+    if(strncmp_P(line, PSTR("+CPBR: "), 7) != 0)
+        return;
+
+    uint8_t index;
+    SIM900CardAccount account = this->parsePhonebookEntry(line + 7, index);
+    this->deliveredCount++;
+
+    if(this->pendingAccounts == NULL) {
+        if(this->callback.phonebook != NULL)
+            this->callback.phonebook(index, account);
+    }
+    else if(index >= this->pendingFirst && index - this->pendingFirst < this->pendingSize)
+        this->pendingAccounts[index - this->pendingFirst] = account;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookReport BasicSIM900<Transport, RxBufSize>::syncPhonebook(SIM900CardAccount* desired, uint8_t count) {
+    SIM900PhonebookReport report;
+    report.success = false;
+    report.entries = 0;
+    report.elapsed = 0;
+    report.per_second = 0;
+
+    uint32_t start = millis();
+    SIM900PhonebookCapacity capacity = this->phonebookCapacity();
+
+    if(capacity.max == 0 || count > capacity.max)
+        return report;
+
+    uint8_t bitmap[64];
+    memset(bitmap, 0, sizeof(bitmap));
+
+    if(capacity.used > 0) {
+        this->await();
+        this->pendingAccounts = desired;
+        this->pendingSize = count;
+        this->pendingBitmap = bitmap;
+
+        this->startCommand(NULL, SIM900_PHONEBOOK_TIMEOUT, F("AT+CPBR=1,"), capacity.max);
+        this->lineHandler = &BasicSIM900::receivePhonebookSyncLine;
+        this->await();
+
+        this->pendingAccounts = NULL;
+        this->pendingBitmap = NULL;
+
+        if(this->commandStatus != SIM900_COMMAND_OK)
+            return report;
+    }
+
+    report.success = true;
+    for(uint16_t index = 1; index <= capacity.max; index++) {
+        bool occupied = bitmap[index / 8] & (1 << (index % 8));
+        bool matching = bitmap[32 + index / 8] & (1 << (index % 8));
+
+        if(index <= count && desired[index - 1].number.length() > 0) {
+            if(matching)
+                continue;
+
+            report.success = this->savePhonebook(index, desired[index - 1]) && report.success;
+        }
+        else if(occupied)
+            report.success = this->deletePhonebook(index) && report.success;
+        else continue;
+
+        report.entries++;
+    }
+
+    report.elapsed = millis() - start;
+    if(report.elapsed > 0)
+        report.per_second = (uint16_t) ((uint32_t) report.entries * 1000UL / report.elapsed);
+
+    return report;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receivePhonebookSyncLine(char* line) {
+    if(strncmp_P(line, PSTR("+CPBR: "), 7) != 0)
+        return;
+
+    uint8_t index;
+    SIM900CardAccount account = this->parsePhonebookEntry(line + 7, index);
+    this->pendingBitmap[index / 8] |= 1 << (index % 8);
+
+    if(index == 0 || index > this->pendingSize)
+        return;
+
+    SIM900CardAccount& desired = this->pendingAccounts[index - 1];
+    if(desired.number == account.number &&
+        desired.name == account.name &&
+        (desired.numberType == 0 || desired.numberType == account.numberType))
+        this->pendingBitmap[32 + index / 8] |= 1 << (index % 8);
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CardAccount BasicSIM900<Transport, RxBufSize>::parsePhonebookEntry(char* result, uint8_t& index) {
+    SIM900CardAccount accountInfo;
+    accountInfo.numberType = static_cast<SIM900PhonebookType>(0);
+
+    SIM900Tokenizer tokens(result);
+    index = (uint8_t) tokens.nextInt();
+
+    char* number = tokens.next();
+    uint8_t type = (uint8_t) tokens.nextInt();
+    char* name = tokens.next();
+
+    if(number != NULL)
+        accountInfo.number = number;
+
+    if(type == 129 || type == 145)
+        accountInfo.numberType = static_cast<SIM900PhonebookType>(type);
+    else accountInfo.numberType = static_cast<SIM900PhonebookType>(0);
+
+    if(name != NULL)
+        accountInfo.name = name;
+
+    return accountInfo;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::deletePhonebook(uint8_t index) {
+    this->sendCommand(F("AT+CPBW="), index);
+
+    if(!this->isSuccessCommand())
+        return false;
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    this->unindexPhonebook(index);
+#endif
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::buildPhonebookIndex() {
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    this->indexCount = 0;
+    this->indexBuilt = false;
+
+    SIM900PhonebookCapacity capacity = this->phonebookCapacity();
+    if(capacity.max == 0 || capacity.max > SIM900_PHONEBOOK_INDEX_SIZE)
+        return false;
+
+    if(capacity.used > 0) {
+        this->await();
+        this->startCommand(NULL, SIM900_PHONEBOOK_TIMEOUT, F("AT+CPBR=1,"), capacity.max);
+        this->lineHandler = &BasicSIM900::receivePhonebookIndexLine;
+        this->await();
+
+        if(this->commandStatus != SIM900_COMMAND_OK) {
+            this->indexCount = 0;
+            return false;
+        }
+    }
+
+    return (this->indexBuilt = true);
+#else
+    return false;
+#endif
+}
+
+template<class Transport, uint16_t RxBufSize>
+int16_t BasicSIM900<Transport, RxBufSize>::findPhonebook(String number) {
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+    if(this->indexBuilt) {
+        uint16_t hash = this->hashNumber(number.c_str());
+
+        for(uint8_t i = 0; i < this->indexCount; i++) {
+            if(this->indexHashes[i] != hash)
+                continue;
+
+            SIM900CardAccount account = this->retrievePhonebook(this->indexEntries[i]);
+            if(this->matchNumber(account.number.c_str(), number.c_str()))
+                return this->indexEntries[i];
+        }
+
+        return -1;
+    }
+#endif
+
+    SIM900PhonebookCapacity capacity = this->phonebookCapacity();
+    if(capacity.used == 0)
+        return -1;
+
+    this->await();
+    this->pendingNumber = number.c_str();
+    this->pendingMatch = -1;
+
+    this->startCommand(NULL, SIM900_PHONEBOOK_TIMEOUT, F("AT+CPBR=1,"), capacity.max);
+    this->lineHandler = &BasicSIM900::receivePhonebookMatchLine;
+    this->await();
+
+    this->pendingNumber = NULL;
+    return this->pendingMatch;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receivePhonebookMatchLine(char* line) {
+    if(this->pendingMatch != -1 || strncmp_P(line, PSTR("+CPBR: "), 7) != 0)
+        return;
+
+    uint8_t index;
+    SIM900CardAccount account = this->parsePhonebookEntry(line + 7, index);
+
+    if(this->matchNumber(account.number.c_str(), this->pendingNumber))
+        this->pendingMatch = index;
+}
+
+template<class Transport, uint16_t RxBufSize>
+uint16_t BasicSIM900<Transport, RxBufSize>::hashNumber(const char* number) {
+    uint32_t hash = 2166136261UL;
+    uint8_t digits = 0;
+
+    for(const char* ch = number + strlen(number);
+        ch > number && digits < SIM900_PHONEBOOK_MATCH_DIGITS;) {
+        if(!isdigit(*--ch))
+            continue;
+
+        hash = (hash ^ (uint8_t) *ch) * 16777619UL;
+        digits++;
+    }
+
+    return (uint16_t) (hash ^ (hash >> 16));
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::matchNumber(const char* first, const char* second) {
+    const char* a = first + strlen(first);
+    const char* b = second + strlen(second);
+
+    for(uint8_t digits = 0; digits < SIM900_PHONEBOOK_MATCH_DIGITS; digits++) {
+        while(a > first && !isdigit(*(a - 1)))
+            a--;
+        while(b > second && !isdigit(*(b - 1)))
+            b--;
+
+        if(a == first || b == second)
+            return a == first && b == second && digits > 0;
+
+        if(*--a != *--b)
+            return false;
+    }
+
+    return true;
+}
+
+#if SIM900_PHONEBOOK_INDEX_SIZE > 0
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::receivePhonebookIndexLine(char* line) {
+    if(strncmp_P(line, PSTR("+CPBR: "), 7) != 0)
+        return;
+
+    uint8_t index;
+    SIM900CardAccount account = this->parsePhonebookEntry(line + 7, index);
+    this->indexPhonebook(index, account.number.c_str());
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::indexPhonebook(uint8_t index, const char* number) {
+    this->unindexPhonebook(index);
+
+    if(this->indexCount == SIM900_PHONEBOOK_INDEX_SIZE) {
+        this->indexBuilt = false;
+        return;
+    }
+
+    this->indexHashes[this->indexCount] = this->hashNumber(number);
+    this->indexEntries[this->indexCount++] = index;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::unindexPhonebook(uint8_t index) {
+    for(uint8_t i = 0; i < this->indexCount; i++)
+        if(this->indexEntries[i] == index) {
+            this->indexCount--;
+
+            this->indexHashes[i] = this->indexHashes[this->indexCount];
+            this->indexEntries[i] = this->indexEntries[this->indexCount];
+            return;
+        }
+}
+#endif
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookCapacity BasicSIM900<Transport, RxBufSize>::phonebookCapacity() {
+    this->sendCommand(F("AT+CPBS?"));
+    return this->parsePhonebookCapacity(this->queryResult());
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::phonebookCapacity(SIM900PhonebookCapacityCallback callback) {
+    if(!this->startCommand(F("AT+CPBS?"), &BasicSIM900::completePhonebookCapacity))
+        return false;
+
+    this->callback.phonebookCapacity = callback;
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900PhonebookCapacity BasicSIM900<Transport, RxBufSize>::parsePhonebookCapacity(char* result) {
+    SIM900PhonebookCapacity capacity;
+    capacity.used = capacity.max = 0;
+    capacity.memoryType = F("");
+
+    SIM900Tokenizer tokens(result);
+    char* memoryType = tokens.next();
+
+    if(memoryType != NULL)
+        capacity.memoryType = memoryType;
+
+    capacity.used = (uint8_t) tokens.nextInt();
+    capacity.max = (uint8_t) tokens.nextInt();
+
+    return capacity;
+}
+
+template<class Transport, uint16_t RxBufSize>
+SIM900CardAccount BasicSIM900<Transport, RxBufSize>::cardNumber() {
+    this->sendCommand(F("AT+CNUM"));
+
+    SIM900CardAccount account;
+    account.name = F("");
+
+    char* result = this->queryResult();
+    if(result == NULL)
+        return account;
+
+    SIM900Tokenizer tokens(result);
+    char* name = tokens.next();
+    char* number = tokens.next();
+
+    account.name = name != NULL ? name : "";
+    account.number = number != NULL ? number : "";
+    account.type = (uint8_t) tokens.nextInt();
+    account.speed = (uint8_t) tokens.nextInt();
+    account.service = intToSIM900CardService((uint8_t) tokens.nextInt());
+    account.numberType = static_cast<SIM900PhonebookType>(0);
+
+    return account;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::query(SIM900Batch& batch) {
+    this->await();
+    if(!this->query(batch, NULL))
+        return false;
+
+    this->await();
+    return this->commandStatus == SIM900_COMMAND_OK;
+}
+
+template<class Transport, uint16_t RxBufSize>
+bool BasicSIM900<Transport, RxBufSize>::query(SIM900Batch& batch, SIM900ResultCallback callback) {
+    batch.received = 0;
+
+    uint8_t queries = batch.queries & (SIM900_QUERY_SIGNAL | SIM900_QUERY_OPERATOR |
+        SIM900_QUERY_PHONEBOOK_CAPACITY | SIM900_QUERY_RTC);
+    if(queries == 0)
+        return false;
+
+    uint8_t first = 0;
+    while(!(queries & (1 << first)))
+        first++;
+
+    if(!this->startCommand(
+        &BasicSIM900::completeBatch,
+        SIM900_RESPONSE_TIMEOUT,
+        reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&SIM900_QUERY_COMMANDS[first])),
+        SIM900QueryList(queries & (queries - 1))
+    ))
+        return false;
+
+    this->pendingBatch = &batch;
+    this->callback.result = callback;
+
+    return true;
+}
+
+template<class Transport, uint16_t RxBufSize>
+void BasicSIM900<Transport, RxBufSize>::completeBatch(SIM900CommandStatus status) {
+    SIM900Batch* batch = this->pendingBatch;
+    this->pendingBatch = NULL;
+
+    SIM900Tokenizer lines(this->responseBuffer);
+    while(lines.hasNext()) {
+        char* line = lines.next('\n');
+
+        if(strncmp_P(line, PSTR("+CSQ: "), 6) == 0) {
+            batch->signal = this->parseSignal(line + 6);
+            batch->received |= SIM900_QUERY_SIGNAL;
+        }
+        else if(strncmp_P(line, PSTR("+COPS: "), 7) == 0) {
+            batch->networkOperator = this->parseOperator(line + 7);
+            batch->received |= SIM900_QUERY_OPERATOR;
+        }
+        else if(strncmp_P(line, PSTR("+CPBS: "), 7) == 0) {
+            batch->phonebookCapacity = this->parsePhonebookCapacity(line + 7);
+            batch->received |= SIM900_QUERY_PHONEBOOK_CAPACITY;
+        }
+        else if(strncmp_P(line, PSTR("+CCLK: "), 7) == 0) {
+            batch->rtc = this->parseRtc(line + 7);
+            batch->received |= SIM900_QUERY_RTC;
+        }
+    }
+
+    this->completeResult(status);
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::manufacturer() {
+    this->sendCommand(F("AT+GMI"));
+    return String(this->rawQueryOnLine(0));
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::softwareRelease() {
+    this->sendCommand(F("AT+GMR"));
+
+    char* result = this->rawQueryOnLine(0);
+    char* revision = strrchr(result, ':');
+
+    return String(revision != NULL ? revision + 1 : result);
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::imei() {
+    this->sendCommand(F("AT+GSN"));
+    return String(this->rawQueryOnLine(0));
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::chipModel() {
+    this->sendCommand(F("AT+GMM"));
+    return String(this->rawQueryOnLine(0));
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::chipName() {
+    this->sendCommand(F("AT+GOI"));
+    return String(this->rawQueryOnLine(0));
+}
+
+template<class Transport, uint16_t RxBufSize>
+String BasicSIM900<Transport, RxBufSize>::ipAddress() {
+    this->sendCommand(F("AT+CIFSR"));
+    return String(this->rawQueryOnLine(0));
+}
+
+#endif
\ No newline at end of file
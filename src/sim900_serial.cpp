@@ -0,0 +1,253 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sim900_serial.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+/// A baud rate and the termios speed selecting it.
+typedef struct _SIM900SerialSpeed {
+    uint32_t baud;
+    speed_t speed;
+} SIM900SerialSpeed;
+
+/// Baud rates supported by SIM900SerialPort::setBaudRate().
+static const SIM900SerialSpeed SIM900_SERIAL_SPEEDS[] = {
+    {1200, B1200},
+    {2400, B2400},
+    {4800, B4800},
+    {9600, B9600},
+    {19200, B19200},
+    {38400, B38400},
+    {57600, B57600},
+    {115200, B115200},
+    {230400, B230400},
+    {460800, B460800},
+    {921600, B921600}
+};
+
+SIM900SerialPort::SIM900SerialPort() {
+    this->peerPath[0] = '\0';
+}
+
+SIM900SerialPort::~SIM900SerialPort() {
+    this->close();
+}
+
+bool SIM900SerialPort::configure(int descriptor, uint32_t baud) {
+    speed_t speed = 0;
+    bool supported = false;
+
+    for(uint8_t i = 0; i < sizeof(SIM900_SERIAL_SPEEDS) / sizeof(SIM900_SERIAL_SPEEDS[0]); i++)
+        if(SIM900_SERIAL_SPEEDS[i].baud == baud) {
+            speed = SIM900_SERIAL_SPEEDS[i].speed;
+            supported = true;
+        }
+
+    struct termios options;
+    if(!supported || tcgetattr(descriptor, &options) != 0)
+        return false;
+
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;
+
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+
+    return tcsetattr(descriptor, TCSADRAIN, &options) == 0;
+}
+
+bool SIM900SerialPort::open(const char* path, uint32_t baud) {
+    this->close();
+
+    int descriptor = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(descriptor < 0)
+        return false;
+
+    if(!this->configure(descriptor, baud)) {
+        ::close(descriptor);
+        return false;
+    }
+
+    this->fd = descriptor;
+    return true;
+}
+
+bool SIM900SerialPort::openPseudoTerminal(uint32_t baud) {
+    this->close();
+
+    int descriptor = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(descriptor < 0)
+        return false;
+
+    if(grantpt(descriptor) != 0 || unlockpt(descriptor) != 0 ||
+        ptsname_r(descriptor, this->peerPath, sizeof(this->peerPath)) != 0 ||
+        !this->configure(descriptor, baud)) {
+        ::close(descriptor);
+        this->peerPath[0] = '\0';
+
+        return false;
+    }
+
+    this->fd = descriptor;
+    return true;
+}
+
+const char* SIM900SerialPort::peerName() {
+    return this->peerPath;
+}
+
+void SIM900SerialPort::close() {
+    if(this->fd >= 0)
+        ::close(this->fd);
+
+    this->fd = -1;
+    this->head = this->count = 0;
+    this->peerPath[0] = '\0';
+}
+
+bool SIM900SerialPort::isOpen() {
+    return this->fd >= 0;
+}
+
+bool SIM900SerialPort::setBaudRate(uint32_t baud) {
+    if(this->fd < 0)
+        return false;
+
+    tcdrain(this->fd);
+    return this->configure(this->fd, baud);
+}
+
+void SIM900SerialPort::setWaitTime(uint32_t milliseconds) {
+    this->waitTime = milliseconds;
+}
+
+bool SIM900SerialPort::wait(uint32_t timeout) {
+    if(this->fill() > 0)
+        return true;
+
+    if(this->fd < 0)
+        return false;
+
+    struct pollfd request;
+    request.fd = this->fd;
+    request.events = POLLIN;
+    request.revents = 0;
+
+    if(poll(&request, 1, (int) timeout) <= 0)
+        return false;
+
+    return this->fill() > 0;
+}
+
+int SIM900SerialPort::descriptor() {
+    return this->fd;
+}
+
+uint16_t SIM900SerialPort::fill() {
+    while(this->fd >= 0 && this->count < SIM900_SERIAL_BUFFER_SIZE) {
+        uint16_t tail = (this->head + this->count) % SIM900_SERIAL_BUFFER_SIZE;
+        uint16_t space = tail >= this->head ?
+            SIM900_SERIAL_BUFFER_SIZE - tail :
+            this->head - tail;
+
+        ssize_t received = ::read(this->fd, this->buffer + tail, space);
+        if(received <= 0)
+            break;
+
+        this->count += received;
+    }
+
+    return this->count;
+}
+
+int SIM900SerialPort::available() {
+    if(this->fill() == 0 && this->waitTime > 0)
+        this->wait(this->waitTime);
+
+    return this->count;
+}
+
+int SIM900SerialPort::read() {
+    if(this->count == 0 && this->fill() == 0)
+        return -1;
+
+    uint8_t data = this->buffer[this->head];
+    this->head = (this->head + 1) % SIM900_SERIAL_BUFFER_SIZE;
+    this->count--;
+
+    return data;
+}
+
+int SIM900SerialPort::peek() {
+    if(this->count == 0 && this->fill() == 0)
+        return -1;
+
+    return this->buffer[this->head];
+}
+
+size_t SIM900SerialPort::write(uint8_t data) {
+    return this->write(&data, 1);
+}
+
+size_t SIM900SerialPort::write(const uint8_t* data, size_t size) {
+    size_t written = 0;
+
+    while(this->fd >= 0 && written < size) {
+        ssize_t sent = ::write(this->fd, data + written, size - written);
+
+        if(sent > 0) {
+            written += sent;
+            continue;
+        }
+
+        if(sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            break;
+
+        struct pollfd request;
+        request.fd = this->fd;
+        request.events = POLLOUT;
+        request.revents = 0;
+
+        if(poll(&request, 1, SIM900_SERIAL_WRITE_TIMEOUT) <= 0)
+            break;
+    }
+
+    return written;
+}
+
+void SIM900SerialPort::flush() {
+    if(this->fd >= 0)
+        tcdrain(this->fd);
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * 
+ * @file sim900_serial.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief This header defines a Stream over a POSIX serial port, for driving SIM900 modules from Linux hosts.
+ * 
+ */
+
+#ifndef SIM900_SERIAL_H
+#define SIM900_SERIAL_H
+
+#if defined(__linux__)
+
+#include <Arduino.h>
+
+#ifndef SIM900_SERIAL_BUFFER_SIZE
+/// Size in bytes of the receive buffer of a SIM900SerialPort.
+#define SIM900_SERIAL_BUFFER_SIZE 1024
+#endif
+
+#ifndef SIM900_SERIAL_WRITE_TIMEOUT
+/// Time in milliseconds a write to a SIM900SerialPort waits for the port to accept more data.
+#define SIM900_SERIAL_WRITE_TIMEOUT 1000
+#endif
+
+/**
+ * 
+ * @class SIM900SerialPort
+ * @brief A Stream over a serial device or pseudo-terminal of a POSIX host.
+ *
+ * The port is opened in raw, non-blocking mode. Received bytes are read into a bounded buffer whenever the stream is
+ * asked for data, so read(), peek() and available() never block unless a wait time is set with setWaitTime(). Pass
+ * the port to the SIM900 constructor to talk to a module on a device such as /dev/ttyUSB0.
+ * 
+ */
+class SIM900SerialPort : public Stream {
+private:
+    /// The file descriptor of the open port, or -1.
+    int fd = -1;
+
+    /// The received bytes not read yet, as a ring buffer.
+    uint8_t buffer[SIM900_SERIAL_BUFFER_SIZE];
+
+    /// The position of the oldest unread byte in the buffer.
+    uint16_t head = 0;
+
+    /// The number of unread bytes in the buffer.
+    uint16_t count = 0;
+
+    /// Time in milliseconds available() waits for data when the buffer is empty.
+    uint32_t waitTime = 0;
+
+    /// The path of the terminal paired with an open pseudo-terminal.
+    char peerPath[64];
+
+    /// Put an open file descriptor in raw, non-blocking mode at the given baud rate.
+    bool configure(int descriptor, uint32_t baud);
+
+    /// Move the bytes waiting on the port into the buffer, returning the number of unread bytes.
+    uint16_t fill();
+
+public:
+    SIM900SerialPort();
+    ~SIM900SerialPort();
+
+    /**
+     * 
+     * @brief Open a serial device.
+     *
+     * @param path The path of the device, such as "/dev/ttyUSB0".
+     * @param baud The baud rate to use.
+     * @return True if the device was opened and configured, false otherwise.
+     * 
+     */
+    bool open(const char* path, uint32_t baud = 9600);
+
+    /**
+     * 
+     * @brief Open a new pseudo-terminal.
+     *
+     * The port becomes the master side of the pseudo-terminal. Another program, or a second SIM900SerialPort, can
+     * open the path returned by peerName() to act as the other end of the line.
+     *
+     * @param baud The baud rate to set on the terminal.
+     * @return True if the pseudo-terminal was opened, false otherwise.
+     * 
+     */
+    bool openPseudoTerminal(uint32_t baud = 9600);
+
+    /**
+     * 
+     * @brief Get the path of the terminal paired with a pseudo-terminal opened by openPseudoTerminal().
+     *
+     * @return The path of the terminal, or an empty string if no pseudo-terminal is open.
+     * 
+     */
+    const char* peerName();
+
+    /**
+     * 
+     * @brief Close the port, discarding any unread data.
+     * 
+     */
+    void close();
+
+    /**
+     * 
+     * @brief Check if the port is open.
+     *
+     * @return True if the port is open, false otherwise.
+     * 
+     */
+    bool isOpen();
+
+    /**
+     * 
+     * @brief Change the baud rate of the open port.
+     *
+     * Pending output is sent at the old rate first. This can be used as the reopen callback of
+     * SIM900::detectBaudRate() and SIM900::setBaudRate() through a small wrapper function.
+     *
+     * @param baud The new baud rate, one of the standard rates from 1200 to 921600.
+     * @return True if the baud rate was changed, false if it is not supported or the port is not open.
+     * 
+     */
+    bool setBaudRate(uint32_t baud);
+
+    /**
+     * 
+     * @brief Set how long available() waits for data when none has been received.
+     *
+     * With the default of 0, the port never blocks and the command engine polls it continuously. A wait time lets a
+     * host program sleep in poll(2) instead while a blocking SIM900 method waits for its response.
+     *
+     * @param milliseconds The time to wait in milliseconds.
+     * 
+     */
+    void setWaitTime(uint32_t milliseconds);
+
+    /**
+     * 
+     * @brief Wait until data is received on the port.
+     *
+     * @param timeout The time in milliseconds to wait.
+     * @return True if unread data is available, false on timeout.
+     * 
+     */
+    bool wait(uint32_t timeout);
+
+    /**
+     * 
+     * @brief Get the file descriptor of the open port, to wait on it together with other descriptors.
+     *
+     * @return The file descriptor, or -1 if the port is not open.
+     * 
+     */
+    int descriptor();
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t size);
+    void flush();
+
+    using Print::write;
+};
+
+#endif
+
+#endif
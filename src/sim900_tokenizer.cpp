@@ -0,0 +1,71 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sim900_tokenizer.h"
+
+SIM900Tokenizer::SIM900Tokenizer(char* text):cursor(text){}
+
+bool SIM900Tokenizer::hasNext() {
+    return this->cursor != NULL;
+}
+
+char* SIM900Tokenizer::next(char delimiter) {
+    if(this->cursor == NULL)
+        return NULL;
+
+    char* field = this->cursor;
+    while(*field == ' ')
+        field++;
+
+    char* end = field;
+    if(*field == '"') {
+        field++;
+
+        char* quote = strchr(field, '"');
+        if(quote == NULL) {
+            this->cursor = NULL;
+            return field;
+        }
+
+        *quote = '\0';
+        end = quote + 1;
+    }
+
+    end = delimiter == '\0' ? NULL : strchr(end, delimiter);
+    if(end == NULL)
+        this->cursor = NULL;
+    else {
+        *end = '\0';
+        this->cursor = end + 1;
+    }
+
+    return field;
+}
+
+long SIM900Tokenizer::nextInt(char delimiter) {
+    char* field = this->next(delimiter);
+    if(field == NULL)
+        return 0;
+
+    return strtol(field, NULL, 10);
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * 
+ * @file sim900_tokenizer.h
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief This header defines a non-allocating tokenizer for the fields of SIM900 response lines.
+ * 
+ */
+
+#ifndef SIM900_TOKENIZER_H
+#define SIM900_TOKENIZER_H
+
+#include <Arduino.h>
+
+/**
+ * 
+ * @class SIM900Tokenizer
+ * @brief A non-owning view which splits a response line into its fields in place.
+ *
+ * The tokenizer walks over a mutable, null-terminated text and terminates each field where its delimiter was,
+ * so fields can be read as plain C strings without copying them or allocating any memory. Double quotes around
+ * a field are stripped, and delimiters inside quoted fields are ignored.
+ * 
+ */
+class SIM900Tokenizer {
+private:
+    /// The position of the next field, or NULL once all fields were consumed.
+    char* cursor;
+
+public:
+    /**
+     * 
+     * @brief Constructor for the SIM900Tokenizer class.
+     *
+     * @param text The null-terminated text to tokenize. It is modified in place and may be NULL.
+     * 
+     */
+    SIM900Tokenizer(char* text);
+
+    /**
+     * 
+     * @brief Check if there are fields left to read.
+     *
+     * @return True if another field can be read, false otherwise.
+     * 
+     */
+    bool hasNext();
+
+    /**
+     * 
+     * @brief Read the next field.
+     *
+     * @param delimiter The character which terminates the field.
+     * @return The field without surrounding quotes, or NULL if there are no fields left.
+     * 
+     */
+    char* next(char delimiter = ',');
+
+    /**
+     * 
+     * @brief Read the next field as a decimal integer.
+     *
+     * @param delimiter The character which terminates the field.
+     * @return The value of the field, or 0 if there are no fields left or the field is not a number.
+     * 
+     */
+    long nextInt(char delimiter = ',');
+};
+
+#endif
@@ -0,0 +1,445 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *
+ * @file benchmark.cpp
+ * @brief Round-trip latency and throughput benchmark of the library against the virtual modem.
+ *
+ * Every scenario runs at 9600 and 115200 baud against a modem with typical processing times: 20 ms per command,
+ * 3 s for the network to accept an SMS, 2 ms per phonebook entry read, 1 s to open a TCP connection and 150 ms for
+ * the server to answer. The built-in HTTP engine is skipped at baud rates too slow to upload the body within the input
+ * time given to AT+HTTPDATA. Times are measured on the simulated clock, so the results only change when the library does.
+ *
+ * For each call the benchmark reports its latency in microseconds, the bytes written and read on the serial line, and
+ * the high-water mark of the String allocations made during the call. Bulk scenarios add the reports returned by the
+ * library. The statistics collected with SIM900_ENABLE_STATS are listed per baud rate. The results are written as
+ * JSON to the file given as the first argument, or to the standard output.
+ *
+ */
+
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifndef SIM900_ENABLE_STATS
+#error "The benchmark must be built with SIM900_ENABLE_STATS defined."
+#endif
+
+namespace {
+    /// Size in bytes of the HTTP bodies uploaded and downloaded.
+    const uint32_t HTTP_BODY_SIZE = 65536;
+
+    /// Number of messages sent by the bulk SMS scenario.
+    const uint16_t BULK_SMS_COUNT = 100;
+
+    /// Number of entries read by the phonebook dump scenario.
+    const uint8_t PHONEBOOK_DUMP_SIZE = 250;
+
+    const uint32_t BAUD_RATES[] = {9600, 115200};
+
+    uint32_t uploaded = 0;
+    uint32_t downloaded = 0;
+    uint32_t phonebookEntries = 0;
+
+    uint16_t uploadSource(uint8_t* buffer, uint16_t size) {
+        for(uint16_t i = 0; i < size; i++)
+            buffer[i] = (uint8_t) ('a' + (uploaded + i) % 26);
+
+        uploaded += size;
+        return size;
+    }
+
+    void downloadSink(const uint8_t* chunk, uint16_t length) {
+        (void) chunk;
+        downloaded += length;
+    }
+
+    void phonebookSink(uint8_t index, SIM900CardAccount account) {
+        (void) index;
+        (void) account;
+
+        phonebookEntries++;
+    }
+
+    void receivedSink(SIM900ReceivedSMS sms) {
+        (void) sms;
+    }
+
+    VirtualModem::HTTPReply httpServer(const VirtualModem::HTTPRequest& request) {
+        VirtualModem::HTTPReply reply;
+
+        if(request.method == "GET")
+            reply.body = std::string(HTTP_BODY_SIZE, 'x');
+        else reply.body = std::to_string(request.body.size());
+
+        return reply;
+    }
+
+    std::string quote(const std::string& text) {
+        std::string result = "\"";
+
+        for(size_t i = 0; i < text.size(); i++) {
+            if(text[i] == '"' || text[i] == '\\')
+                result += '\\';
+
+            result += text[i];
+        }
+
+        return result + "\"";
+    }
+
+    /// A JSON object written field by field.
+    class Object {
+    private:
+        std::string text;
+
+    public:
+        Object& field(const std::string& key, const std::string& json) {
+            this->text += (this->text.empty() ? "" : ", ") + quote(key) + ": " + json;
+            return *this;
+        }
+
+        Object& number(const std::string& key, uint64_t value) {
+            return this->field(key, std::to_string(value));
+        }
+
+        Object& flag(const std::string& key, bool value) {
+            return this->field(key, value ? "true" : "false");
+        }
+
+        Object& string(const std::string& key, const std::string& value) {
+            return this->field(key, quote(value));
+        }
+
+        std::string json() const {
+            return "{" + this->text + "}";
+        }
+    };
+
+    std::string array(const std::vector<std::string>& items, const char* indent) {
+        std::string result = "[";
+
+        for(size_t i = 0; i < items.size(); i++)
+            result += (i == 0 ? "\n" : ",\n") + std::string(indent) + "  " + items[i];
+
+        return result + (items.empty() ? "]" : "\n" + std::string(indent) + "]");
+    }
+
+    /// Measures the calls made against one modem.
+    class Bench {
+    private:
+        VirtualModem& modem;
+        std::vector<std::string> results;
+
+        uint64_t start;
+        uint64_t sent;
+        uint64_t received;
+        size_t heap;
+
+    public:
+        explicit Bench(VirtualModem& _modem):modem(_modem) { }
+
+        void begin() {
+            ArduinoShim::resetHeapPeak();
+
+            this->heap = ArduinoShim::heapUsed();
+            this->start = ArduinoShim::now();
+            this->sent = this->modem.bytesFromHost();
+            this->received = this->modem.bytesToHost();
+        }
+
+        Object end(const std::string& name, bool success) {
+            Object result;
+            result.string("name", name)
+                .flag("success", success)
+                .number("latency_us", ArduinoShim::now() - this->start)
+                .number("bytes_sent", this->modem.bytesFromHost() - this->sent)
+                .number("bytes_received", this->modem.bytesToHost() - this->received)
+                .number("heap_peak", ArduinoShim::heapPeak() - this->heap);
+
+            return result;
+        }
+
+        void record(const Object& result) {
+            this->results.push_back(result.json());
+        }
+
+        template<typename Call>
+        void measure(const std::string& name, Call call) {
+            this->begin();
+            bool success = call();
+            this->record(this->end(name, success));
+        }
+
+        const std::vector<std::string>& calls() const {
+            return this->results;
+        }
+    };
+
+    void fillPhonebook(VirtualModem& modem) {
+        for(int i = 1; i <= PHONEBOOK_DUMP_SIZE; i++) {
+            VirtualModem::Entry entry;
+            entry.number = "+1555" + std::to_string(1000000 + i);
+            entry.type = 145;
+            entry.name = "Contact " + std::to_string(i);
+
+            modem.phonebook[i] = entry;
+        }
+    }
+
+    SIM900HTTPRequest httpRequest(const char* method) {
+        SIM900HTTPRequest request;
+        request.method = method;
+        request.domain = "example.com";
+        request.resource = "/data";
+        request.port = 80;
+        request.headers = NULL;
+        request.header_count = 0;
+        request.data = "";
+
+        return request;
+    }
+
+    void runCalls(Bench& bench, SIM900& sim900, VirtualModem& modem) {
+        bench.measure("handshake", [&]() { return sim900.handshake(); });
+        bench.measure("signal", [&]() { return sim900.signal().rssi == modem.rssi; });
+        bench.measure("networkOperator", [&]() { return sim900.networkOperator().name.length() > 0; });
+        bench.measure("cardNumber", [&]() { return sim900.cardNumber().number.length() > 0; });
+        bench.measure("manufacturer", [&]() { return sim900.manufacturer().length() > 0; });
+        bench.measure("softwareRelease", [&]() { return sim900.softwareRelease().length() > 0; });
+        bench.measure("imei", [&]() { return sim900.imei().length() > 0; });
+        bench.measure("chipModel", [&]() { return sim900.chipModel().length() > 0; });
+        bench.measure("chipName", [&]() { return sim900.chipName().length() > 0; });
+        bench.measure("isCardReady", [&]() { return sim900.isCardReady(); });
+
+        bench.measure("updateRtc", [&]() {
+            SIM900RTC time;
+            time.year = 25;
+            time.month = time.day = 1;
+            time.hour = time.minute = time.second = 0;
+            time.gmt = 0;
+
+            return sim900.updateRtc(time);
+        });
+        bench.measure("rtc", [&]() { return sim900.rtc().year == 25; });
+
+        bench.measure("phonebookCapacity", [&]() { return sim900.phonebookCapacity().max > 0; });
+        bench.measure("savePhonebook", [&]() {
+            SIM900CardAccount account;
+            account.name = "Benchmark";
+            account.number = "+15559990000";
+            account.numberType = static_cast<SIM900PhonebookType>(145);
+
+            return sim900.savePhonebook(1, account);
+        });
+        bench.measure("retrievePhonebook", [&]() { return sim900.retrievePhonebook(1).number.length() > 0; });
+        bench.measure("findPhonebook", [&]() { return sim900.findPhonebook("+15559990000") == 1; });
+        bench.measure("deletePhonebook", [&]() { return sim900.deletePhonebook(1); });
+
+        bench.measure("query", [&]() {
+            SIM900Batch batch;
+            batch.queries = SIM900_QUERY_SIGNAL | SIM900_QUERY_OPERATOR |
+                SIM900_QUERY_PHONEBOOK_CAPACITY | SIM900_QUERY_RTC;
+
+            return sim900.query(batch) && batch.received == batch.queries;
+        });
+
+        bench.measure("sendSMS", [&]() { return sim900.sendSMS("+15557654321", "Benchmark message"); });
+        bench.measure("readSMS", [&]() { return sim900.readSMS(receivedSink) >= 0; });
+        bench.measure("dialUp", [&]() { return sim900.dialUp("5551234") == SIM900_DIAL_RESULT_OK; });
+        bench.measure("hangUp", [&]() { return sim900.hangUp(); });
+        bench.measure("measureThroughput", [&]() { return sim900.measureThroughput() > 0; });
+
+        bench.measure("connectAPN", [&]() {
+            SIM900APN apn;
+            apn.apn = "internet";
+            apn.username = apn.password = "";
+
+            return sim900.connectAPN(apn);
+        });
+        bench.measure("enableGPRS", [&]() { return sim900.enableGPRS(); });
+        bench.measure("ipAddress", [&]() { return sim900.ipAddress() == modem.ipAddress.c_str(); });
+    }
+
+    void runBulk(Bench& bench, SIM900& sim900, VirtualModem& modem) {
+        static SIM900SMS messages[BULK_SMS_COUNT];
+        for(uint16_t i = 0; i < BULK_SMS_COUNT; i++) {
+            messages[i].number = "+15557654321";
+            messages[i].message = "Bulk message number ";
+            messages[i].message += (unsigned int) i;
+        }
+
+        bench.begin();
+        SIM900SMSReport sms = sim900.sendSMS(messages, BULK_SMS_COUNT);
+        bench.record(bench.end("sendSMS_bulk", sms.sent == BULK_SMS_COUNT)
+            .number("count", BULK_SMS_COUNT)
+            .number("sent", sms.sent)
+            .number("failed", sms.failed)
+            .number("elapsed_ms", sms.elapsed)
+            .number("per_minute", sms.per_minute));
+
+        for(uint16_t i = 0; i < BULK_SMS_COUNT; i++)
+            messages[i].number = messages[i].message = "";
+
+        fillPhonebook(modem);
+        phonebookEntries = 0;
+
+        bench.begin();
+        SIM900PhonebookReport phonebook = sim900.readPhonebook(1, PHONEBOOK_DUMP_SIZE, phonebookSink);
+        bench.record(bench.end("readPhonebook_dump", phonebook.success && phonebookEntries == PHONEBOOK_DUMP_SIZE)
+            .number("entries", phonebook.entries)
+            .number("elapsed_ms", phonebook.elapsed)
+            .number("per_second", phonebook.per_second));
+
+        static const SIM900HTTPEngine engines[] = {SIM900_HTTP_ENGINE_TCP, SIM900_HTTP_ENGINE_BUILTIN};
+        static const char* const engineNames[] = {"tcp", "builtin"};
+
+        for(uint8_t i = 0; i < 2; i++) {
+            sim900.setHTTPEngine(engines[i]);
+            uploaded = 0;
+
+            if(engines[i] == SIM900_HTTP_ENGINE_BUILTIN &&
+                (uint64_t) HTTP_BODY_SIZE * 10000 / modem.baudRate() >= SIM900_HTTP_TIMEOUT) {
+                bench.record(Object()
+                    .string("name", std::string("http_") + engineNames[i])
+                    .string("skipped", "AT+HTTPDATA cannot take the body within SIM900_HTTP_TIMEOUT at this baud rate"));
+
+                continue;
+            }
+
+            bench.begin();
+            SIM900HTTPResponse upload = sim900.request(httpRequest("POST"), uploadSource, HTTP_BODY_SIZE);
+            bench.record(bench.end(std::string("http_upload_") + engineNames[i],
+                    upload.status == 200 && upload.data == String(HTTP_BODY_SIZE))
+                .number("size", HTTP_BODY_SIZE)
+                .number("status", upload.status)
+                .number("ttfb_ms", upload.ttfb)
+                .number("elapsed_ms", upload.elapsed));
+
+            downloaded = 0;
+
+            bench.begin();
+            SIM900HTTPResponse download = sim900.request(httpRequest("GET"), downloadSink);
+            bench.record(bench.end(std::string("http_download_") + engineNames[i],
+                    download.status == 200 && downloaded == HTTP_BODY_SIZE)
+                .number("size", HTTP_BODY_SIZE)
+                .number("status", download.status)
+                .number("ttfb_ms", download.ttfb)
+                .number("elapsed_ms", download.elapsed));
+        }
+    }
+
+    std::string statistics(SIM900& sim900) {
+        SIM900Stats stats;
+        sim900.statsSnapshot(stats);
+
+        std::vector<std::string> families;
+        for(uint8_t i = 0; i < stats.family_count; i++) {
+            const SIM900CommandStats& family = stats.families[i];
+
+            families.push_back(Object()
+                .string("name", family.name)
+                .number("calls", family.calls)
+                .number("timeouts", family.timeouts)
+                .number("errors", family.errors)
+                .number("min_ms", family.calls > 0 ? family.min_time : 0)
+                .number("max_ms", family.max_time)
+                .number("total_ms", family.total_time)
+                .number("bytes_sent", family.bytes_sent)
+                .number("bytes_received", family.bytes_received)
+                .json());
+        }
+
+        std::string histogram = "[";
+        for(uint8_t i = 0; i < SIM900_STATS_BUCKETS; i++)
+            histogram += (i == 0 ? "" : ", ") + std::to_string(stats.histogram[i]);
+
+        return Object()
+            .field("families", array(families, "      "))
+            .field("histogram", histogram + "]")
+            .json();
+    }
+
+    std::string run(uint32_t baud, bool& success) {
+        VirtualModem modem(baud);
+        modem.setLatency(20000);
+        modem.smsTime = 3000000;
+        modem.phonebookEntryTime = 2000;
+        modem.connectTime = 1000000;
+        modem.serverTime = 150000;
+        modem.server = httpServer;
+
+        static SIM900* sim900;
+        sim900 = new SIM900(modem);
+
+        Bench bench(modem);
+        runCalls(bench, *sim900, modem);
+        runBulk(bench, *sim900, modem);
+
+        for(size_t i = 0; i < bench.calls().size(); i++)
+            if(bench.calls()[i].find("\"success\": false") != std::string::npos) {
+                fprintf(stderr, "failed at %u baud: %s\n", (unsigned) baud, bench.calls()[i].c_str());
+                success = false;
+            }
+
+        std::string result = Object()
+            .number("baud", baud)
+            .field("calls", array(bench.calls(), "    "))
+            .field("stats", statistics(*sim900))
+            .json();
+
+        delete sim900;
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool success = true;
+    std::vector<std::string> runs;
+
+    for(size_t i = 0; i < sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]); i++)
+        runs.push_back(run(BAUD_RATES[i], success));
+
+    std::string json = Object()
+        .string("library", "SIM900")
+        .number("rx_buffer_size", SIM900_RX_BUFFER_SIZE)
+        .field("runs", array(runs, ""))
+        .json() + "\n";
+
+    FILE* out = argc > 1 ? fopen(argv[1], "w") : stdout;
+    if(out == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+
+    fputs(json.c_str(), out);
+    if(out != stdout)
+        fclose(out);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,624 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+
+#include <stdio.h>
+
+/// Time in microseconds yield() lets pass when no registered object has an earlier event.
+#define SHIM_YIELD_QUANTUM 1000
+
+/// Maximum number of objects with timed events registered at once.
+#define SHIM_MAX_CLOCKED 8
+
+static uint64_t shimClock = 0;
+static ArduinoShim::Clocked* shimClocked[SHIM_MAX_CLOCKED];
+
+static size_t shimHeapUsed = 0;
+static size_t shimHeapPeak = 0;
+static uint32_t shimPinWrites = 0;
+
+ArduinoShim::Clocked::Clocked() {
+    for(uint8_t i = 0; i < SHIM_MAX_CLOCKED; i++)
+        if(shimClocked[i] == NULL) {
+            shimClocked[i] = this;
+            return;
+        }
+
+    fprintf(stderr, "Arduino shim: too many clocked objects\n");
+    abort();
+}
+
+ArduinoShim::Clocked::~Clocked() {
+    for(uint8_t i = 0; i < SHIM_MAX_CLOCKED; i++)
+        if(shimClocked[i] == this)
+            shimClocked[i] = NULL;
+}
+
+uint64_t ArduinoShim::now() {
+    return shimClock;
+}
+
+void ArduinoShim::advanceTo(uint64_t time) {
+    if(time > shimClock)
+        shimClock = time;
+}
+
+void ArduinoShim::setClock(uint64_t time) {
+    shimClock = time;
+}
+
+size_t ArduinoShim::heapUsed() {
+    return shimHeapUsed;
+}
+
+size_t ArduinoShim::heapPeak() {
+    return shimHeapPeak;
+}
+
+void ArduinoShim::resetHeapPeak() {
+    shimHeapPeak = shimHeapUsed;
+}
+
+uint32_t ArduinoShim::pinWrites() {
+    return shimPinWrites;
+}
+
+uint32_t millis() {
+    return (uint32_t) (shimClock / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t) shimClock;
+}
+
+void delay(uint32_t milliseconds) {
+    shimClock += (uint64_t) milliseconds * 1000;
+}
+
+void delayMicroseconds(uint32_t microseconds) {
+    shimClock += microseconds;
+}
+
+void yield() {
+    uint64_t target = shimClock + SHIM_YIELD_QUANTUM;
+
+    for(uint8_t i = 0; i < SHIM_MAX_CLOCKED; i++) {
+        if(shimClocked[i] == NULL)
+            continue;
+
+        uint64_t event = shimClocked[i]->nextEvent();
+        if(event <= shimClock)
+            target = shimClock + 1;
+        else if(event < target)
+            target = event;
+    }
+
+    shimClock = target;
+}
+
+void pinMode(uint8_t, uint8_t) {
+}
+
+void digitalWrite(uint8_t, uint8_t) {
+    shimPinWrites++;
+}
+
+/// Allocate or resize a String buffer, keeping its size in front of it for the heap accounting.
+static char* shimReallocate(char* buffer, size_t size) {
+    size_t* block = buffer == NULL ? NULL : (size_t*) buffer - 1;
+    size_t previous = block == NULL ? 0 : *block;
+
+    block = (size_t*) realloc(block, sizeof(size_t) + size);
+    if(block == NULL)
+        return NULL;
+
+    *block = size;
+    shimHeapUsed += size - previous;
+
+    if(shimHeapUsed > shimHeapPeak)
+        shimHeapPeak = shimHeapUsed;
+
+    return (char*) (block + 1);
+}
+
+static void shimFree(char* buffer) {
+    if(buffer == NULL)
+        return;
+
+    size_t* block = (size_t*) buffer - 1;
+    shimHeapUsed -= *block;
+
+    free(block);
+}
+
+void String::init() {
+    this->buffer = NULL;
+    this->capacity = 0;
+    this->len = 0;
+}
+
+void String::invalidate() {
+    shimFree(this->buffer);
+    this->init();
+}
+
+bool String::changeBuffer(unsigned int size) {
+    char* resized = shimReallocate(this->buffer, size + 1);
+    if(resized == NULL)
+        return false;
+
+    this->buffer = resized;
+    this->capacity = size;
+
+    return true;
+}
+
+bool String::reserve(unsigned int size) {
+    if(this->buffer != NULL && this->capacity >= size)
+        return true;
+
+    if(!this->changeBuffer(size))
+        return false;
+
+    if(this->len == 0)
+        this->buffer[0] = '\0';
+
+    return true;
+}
+
+String& String::copy(const char* text, unsigned int length) {
+    if(!this->reserve(length)) {
+        this->invalidate();
+        return *this;
+    }
+
+    this->len = length;
+    memcpy(this->buffer, text, length);
+    this->buffer[length] = '\0';
+
+    return *this;
+}
+
+void String::move(String& other) {
+    shimFree(this->buffer);
+
+    this->buffer = other.buffer;
+    this->capacity = other.capacity;
+    this->len = other.len;
+
+    other.init();
+}
+
+String::String(const char* text) {
+    this->init();
+
+    if(text != NULL)
+        this->copy(text, strlen(text));
+}
+
+String::String(const String& other) {
+    this->init();
+    *this = other;
+}
+
+String::String(String&& other) {
+    this->init();
+    this->move(other);
+}
+
+String::String(const __FlashStringHelper* text) {
+    this->init();
+    *this = text;
+}
+
+String::String(char ch) {
+    this->init();
+    this->copy(&ch, 1);
+}
+
+String::String(unsigned char value, unsigned char base) {
+    this->init();
+    *this = String((unsigned long) value, base);
+}
+
+String::String(int value, unsigned char base) {
+    this->init();
+    *this = String((long) value, base);
+}
+
+String::String(unsigned int value, unsigned char base) {
+    this->init();
+    *this = String((unsigned long) value, base);
+}
+
+String::String(long value, unsigned char base) {
+    this->init();
+
+    char text[2 + 8 * sizeof(long)];
+    if(base == 10) {
+        snprintf(text, sizeof(text), "%ld", value);
+        this->copy(text, strlen(text));
+    }
+    else *this = String((unsigned long) value, base);
+}
+
+String::String(unsigned long value, unsigned char base) {
+    this->init();
+
+    char text[1 + 8 * sizeof(unsigned long)];
+    char* end = text + sizeof(text) - 1;
+    char* start = end;
+
+    *end = '\0';
+    do {
+        uint8_t digit = (uint8_t) (value % base);
+        *--start = (char) (digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while(value > 0);
+
+    this->copy(start, (unsigned int) (end - start));
+}
+
+String::String(double value, unsigned char decimals) {
+    this->init();
+
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    this->copy(text, strlen(text));
+}
+
+String::~String() {
+    shimFree(this->buffer);
+}
+
+unsigned int String::length() const {
+    return this->len;
+}
+
+const char* String::c_str() const {
+    return this->buffer != NULL ? this->buffer : "";
+}
+
+String& String::operator=(const String& other) {
+    if(this == &other)
+        return *this;
+
+    if(other.buffer != NULL)
+        this->copy(other.buffer, other.len);
+    else this->invalidate();
+
+    return *this;
+}
+
+String& String::operator=(String&& other) {
+    if(this != &other)
+        this->move(other);
+
+    return *this;
+}
+
+String& String::operator=(const char* text) {
+    if(text != NULL)
+        this->copy(text, strlen(text));
+    else this->invalidate();
+
+    return *this;
+}
+
+String& String::operator=(const __FlashStringHelper* text) {
+    return *this = reinterpret_cast<const char*>(text);
+}
+
+bool String::concat(const char* text, unsigned int length) {
+    if(text == NULL)
+        return false;
+
+    if(length == 0)
+        return true;
+
+    unsigned int total = this->len + length;
+    if(!this->reserve(total))
+        return false;
+
+    memmove(this->buffer + this->len, text, length);
+    this->len = total;
+    this->buffer[total] = '\0';
+
+    return true;
+}
+
+bool String::concat(const String& other) {
+    return this->concat(other.c_str(), other.len);
+}
+
+bool String::concat(const char* text) {
+    return text != NULL && this->concat(text, strlen(text));
+}
+
+bool String::concat(const __FlashStringHelper* text) {
+    return this->concat(reinterpret_cast<const char*>(text));
+}
+
+bool String::concat(char ch) {
+    return this->concat(&ch, 1);
+}
+
+bool String::concat(unsigned char value) {
+    return this->concat(String(value));
+}
+
+bool String::concat(int value) {
+    return this->concat(String(value));
+}
+
+bool String::concat(unsigned int value) {
+    return this->concat(String(value));
+}
+
+bool String::concat(long value) {
+    return this->concat(String(value));
+}
+
+bool String::concat(unsigned long value) {
+    return this->concat(String(value));
+}
+
+bool String::concat(double value) {
+    return this->concat(String(value));
+}
+
+int String::compareTo(const String& other) const {
+    return strcmp(this->c_str(), other.c_str());
+}
+
+bool String::equals(const String& other) const {
+    return this->len == other.len && this->compareTo(other) == 0;
+}
+
+bool String::equals(const char* text) const {
+    return strcmp(this->c_str(), text != NULL ? text : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    return this->len == other.len && strcasecmp(this->c_str(), other.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return prefix.len <= this->len && strncmp(this->c_str(), prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return suffix.len <= this->len &&
+        strcmp(this->c_str() + this->len - suffix.len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return index < this->len ? this->buffer[index] : '\0';
+}
+
+char String::operator[](unsigned int index) const {
+    return this->charAt(index);
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+
+    if(index >= this->len) {
+        dummy = '\0';
+        return dummy;
+    }
+
+    return this->buffer[index];
+}
+
+int String::indexOf(char ch, unsigned int from) const {
+    if(from >= this->len)
+        return -1;
+
+    const char* found = strchr(this->buffer + from, ch);
+    return found == NULL ? -1 : (int) (found - this->buffer);
+}
+
+int String::indexOf(const String& text, unsigned int from) const {
+    if(from >= this->len)
+        return -1;
+
+    const char* found = strstr(this->buffer + from, text.c_str());
+    return found == NULL ? -1 : (int) (found - this->buffer);
+}
+
+int String::lastIndexOf(char ch) const {
+    if(this->len == 0)
+        return -1;
+
+    const char* found = strrchr(this->buffer, ch);
+    return found == NULL ? -1 : (int) (found - this->buffer);
+}
+
+String String::substring(unsigned int from) const {
+    return this->substring(from, this->len);
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if(from > to) {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+
+    String result;
+    if(from >= this->len)
+        return result;
+
+    if(to > this->len)
+        to = this->len;
+
+    result.copy(this->buffer + from, to - from);
+    return result;
+}
+
+void String::trim() {
+    if(this->len == 0)
+        return;
+
+    unsigned int start = 0, end = this->len;
+    while(start < end && isspace((unsigned char) this->buffer[start]))
+        start++;
+    while(end > start && isspace((unsigned char) this->buffer[end - 1]))
+        end--;
+
+    this->len = end - start;
+    memmove(this->buffer, this->buffer + start, this->len);
+    this->buffer[this->len] = '\0';
+}
+
+void String::toLowerCase() {
+    for(unsigned int i = 0; i < this->len; i++)
+        this->buffer[i] = (char) tolower((unsigned char) this->buffer[i]);
+}
+
+void String::toUpperCase() {
+    for(unsigned int i = 0; i < this->len; i++)
+        this->buffer[i] = (char) toupper((unsigned char) this->buffer[i]);
+}
+
+long String::toInt() const {
+    return this->len == 0 ? 0 : atol(this->buffer);
+}
+
+String operator+(const String& left, const String& right) {
+    String result(left);
+    result.concat(right);
+
+    return result;
+}
+
+String operator+(const char* left, const String& right) {
+    String result(left);
+    result.concat(right);
+
+    return result;
+}
+
+size_t Print::write(const uint8_t* data, size_t size) {
+    size_t written = 0;
+
+    while(size-- > 0) {
+        if(this->write(*data++) == 0)
+            break;
+
+        written++;
+    }
+
+    return written;
+}
+
+size_t Print::printNumber(unsigned long value, uint8_t base) {
+    return this->print(String(value, base));
+}
+
+size_t Print::printFloat(double value, uint8_t decimals) {
+    return this->print(String(value, decimals));
+}
+
+size_t Print::print(const __FlashStringHelper* text) {
+    return this->write(reinterpret_cast<const char*>(text));
+}
+
+size_t Print::print(const String& text) {
+    return this->write(text.c_str(), text.length());
+}
+
+size_t Print::print(const char text[]) {
+    return this->write(text);
+}
+
+size_t Print::print(char ch) {
+    return this->write((uint8_t) ch);
+}
+
+size_t Print::print(unsigned char value, int base) {
+    return this->print((unsigned long) value, base);
+}
+
+size_t Print::print(int value, int base) {
+    return this->print((long) value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+    return this->print((unsigned long) value, base);
+}
+
+size_t Print::print(long value, int base) {
+    if(base == DEC && value < 0) {
+        size_t length = this->print('-');
+        return length + this->printNumber(0UL - (unsigned long) value, DEC);
+    }
+
+    return this->printNumber((unsigned long) value, (uint8_t) base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return this->printNumber(value, (uint8_t) base);
+}
+
+size_t Print::print(double value, int decimals) {
+    return this->printFloat(value, (uint8_t) decimals);
+}
+
+size_t Print::print(const Printable& printable) {
+    return printable.printTo(*this);
+}
+
+size_t Print::println() {
+    return this->write("\r\n");
+}
+
+int Stream::timedRead() {
+    uint32_t start = millis();
+
+    do {
+        int ch = this->read();
+        if(ch >= 0)
+            return ch;
+
+        yield();
+    } while(millis() - start < this->timeout);
+
+    return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+
+    while(count < length) {
+        int ch = this->timedRead();
+        if(ch < 0)
+            break;
+
+        buffer[count++] = (char) ch;
+    }
+
+    return count;
+}
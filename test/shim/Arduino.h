@@ -0,0 +1,300 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *
+ * @file Arduino.h
+ * @brief The subset of the Arduino core used by the library, for building it on a host computer.
+ *
+ * Time is virtual: millis() and micros() only move when yield() or delay() is called, or when a test advances the
+ * clock, so every run is deterministic. While the code under test waits in yield(), the clock skips ahead to the next
+ * event of the registered ArduinoShim::Clocked objects, such as a byte arriving from the virtual modem.
+ *
+ * String keeps its characters on the heap like the Arduino one, and its allocations are tracked so the heap usage of
+ * the library can be measured.
+ *
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PSTR(string) (string)
+
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string)))
+
+#define pgm_read_byte(address) (*(const uint8_t*) (address))
+#define pgm_read_word(address) (*(const uint16_t*) (address))
+#define pgm_read_dword(address) (*(const uint32_t*) (address))
+#define pgm_read_ptr(address) (*(const void* const*) (address))
+
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strlen_P strlen
+#define strncpy_P strncpy
+#define memcmp_P memcmp
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+template<typename A, typename B>
+inline auto min(A a, B b) -> decltype(a < b ? a : b) {
+    return a < b ? a : b;
+}
+
+template<typename A, typename B>
+inline auto max(A a, B b) -> decltype(a > b ? a : b) {
+    return a > b ? a : b;
+}
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t milliseconds);
+void delayMicroseconds(uint32_t microseconds);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+namespace ArduinoShim {
+    /// An object with timed events, which yield() lets the virtual clock skip ahead to.
+    class Clocked {
+    public:
+        Clocked();
+        virtual ~Clocked();
+
+        /// Get the virtual time in microseconds of the next event, or UINT64_MAX if there is none.
+        virtual uint64_t nextEvent() = 0;
+    };
+
+    /// Get the virtual time in microseconds.
+    uint64_t now();
+
+    /// Move the virtual clock forward to the given time in microseconds, if it is later than the current one.
+    void advanceTo(uint64_t time);
+
+    /// Set the virtual clock, e.g., close to the rollover of millis().
+    void setClock(uint64_t time);
+
+    /// Get the number of bytes currently allocated by String objects.
+    size_t heapUsed();
+
+    /// Get the largest number of bytes allocated by String objects at once since the last reset.
+    size_t heapPeak();
+
+    /// Restart the high-water mark of the String allocations from the current usage.
+    void resetHeapPeak();
+
+    /// Get the number of pin writes made through digitalWrite().
+    uint32_t pinWrites();
+}
+
+class String {
+private:
+    char* buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    void init();
+    void invalidate();
+    bool changeBuffer(unsigned int size);
+    String& copy(const char* text, unsigned int length);
+    void move(String& other);
+
+public:
+    String(const char* text = "");
+    String(const String& other);
+    String(String&& other);
+    String(const __FlashStringHelper* text);
+    explicit String(char ch);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(double value, unsigned char decimals = 2);
+    ~String();
+
+    bool reserve(unsigned int size);
+    unsigned int length() const;
+    const char* c_str() const;
+
+    String& operator=(const String& other);
+    String& operator=(String&& other);
+    String& operator=(const char* text);
+    String& operator=(const __FlashStringHelper* text);
+
+    bool concat(const char* text, unsigned int length);
+    bool concat(const String& other);
+    bool concat(const char* text);
+    bool concat(const __FlashStringHelper* text);
+    bool concat(char ch);
+    bool concat(unsigned char value);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(double value);
+
+    template<typename T>
+    String& operator+=(const T& value) {
+        this->concat(value);
+        return *this;
+    }
+
+    int compareTo(const String& other) const;
+    bool equals(const String& other) const;
+    bool equals(const char* text) const;
+    bool equalsIgnoreCase(const String& other) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    bool operator==(const String& other) const { return this->equals(other); }
+    bool operator==(const char* text) const { return this->equals(text); }
+    bool operator!=(const String& other) const { return !this->equals(other); }
+    bool operator!=(const char* text) const { return !this->equals(text); }
+    bool operator<(const String& other) const { return this->compareTo(other) < 0; }
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const;
+    char& operator[](unsigned int index);
+
+    int indexOf(char ch, unsigned int from = 0) const;
+    int indexOf(const String& text, unsigned int from = 0) const;
+    int lastIndexOf(char ch) const;
+
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    long toInt() const;
+};
+
+String operator+(const String& left, const String& right);
+String operator+(const char* left, const String& right);
+
+template<typename T>
+String operator+(const String& left, const T& right) {
+    String result(left);
+    result.concat(right);
+
+    return result;
+}
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& out) const = 0;
+};
+
+class Print {
+private:
+    size_t printNumber(unsigned long value, uint8_t base);
+    size_t printFloat(double value, uint8_t decimals);
+
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t* data, size_t size);
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t write(const char* text) {
+        return text == NULL ? 0 : this->write((const uint8_t*) text, strlen(text));
+    }
+
+    size_t write(const char* data, size_t size) {
+        return this->write((const uint8_t*) data, size);
+    }
+
+    size_t print(const __FlashStringHelper* text);
+    size_t print(const String& text);
+    size_t print(const char text[]);
+    size_t print(char ch);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int decimals = 2);
+    size_t print(const Printable& printable);
+
+    size_t println();
+
+    template<typename T>
+    size_t println(const T& value) {
+        size_t length = this->print(value);
+        return length + this->println();
+    }
+};
+
+class Stream : public Print {
+protected:
+    unsigned long timeout = 1000;
+
+    int timedRead();
+
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long milliseconds) {
+        this->timeout = milliseconds;
+    }
+
+    unsigned long getTimeout() {
+        return this->timeout;
+    }
+
+    size_t readBytes(char* buffer, size_t length);
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return this->readBytes((char*) buffer, length);
+    }
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *
+ * @file test.h
+ * @brief A minimal test registry for the host tests of the library.
+ *
+ * Tests are declared with TEST(name) at namespace scope and use CHECK() and CHECK_EQUAL(), which report the failed
+ * expression and carry on. Each test executable links test_main.cpp, which runs every registered test and returns
+ * the number of failed ones.
+ *
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <sstream>
+#include <string>
+
+namespace Test {
+    typedef void (*Function)();
+
+    /// Add a test to the registry, returning a dummy value so it can run from a static initialiser.
+    bool add(const char* name, Function function);
+
+    /// Record a failed check of the running test.
+    void fail(const char* file, int line, const std::string& message);
+
+    template<typename T>
+    std::string describe(const T& value) {
+        std::ostringstream text;
+        text << value;
+
+        return text.str();
+    }
+
+    inline std::string describe(uint8_t value) {
+        return std::to_string((unsigned) value);
+    }
+
+    inline std::string describe(int8_t value) {
+        return std::to_string((int) value);
+    }
+
+    inline std::string describe(const std::string& value) {
+        return "\"" + value + "\"";
+    }
+
+    inline std::string describe(const char* value) {
+        return value == NULL ? std::string("NULL") : "\"" + std::string(value) + "\"";
+    }
+
+    inline std::string describe(char* value) {
+        return describe((const char*) value);
+    }
+
+    inline std::string describe(bool value) {
+        return value ? "true" : "false";
+    }
+}
+
+#define TEST(name) \
+    static void test_##name(); \
+    static bool registered_##name = Test::add(#name, test_##name); \
+    static void test_##name()
+
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) \
+            Test::fail(__FILE__, __LINE__, #condition); \
+    } while(0)
+
+#define CHECK_EQUAL(expected, actual) \
+    do { \
+        auto expectedValue = (expected); \
+        auto actualValue = (actual); \
+        if(!(expectedValue == actualValue)) \
+            Test::fail(__FILE__, __LINE__, std::string(#actual) + " is " + Test::describe(actualValue) + \
+                ", expected " + Test::describe(expectedValue)); \
+    } while(0)
+
+#define CHECK_TEXT(expected, actual) \
+    CHECK_EQUAL(std::string(expected), std::string(actual))
+
+#endif
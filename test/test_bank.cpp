@@ -0,0 +1,145 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+#include <sim900_bank.h>
+
+#include <vector>
+
+namespace {
+    struct Completion {
+        uint8_t modem;
+        SIM900BankJobType type;
+        bool success;
+    };
+
+    std::vector<Completion> completions;
+
+    void onJob(uint8_t modem, const SIM900BankJob& job, bool success) {
+        Completion completion = {modem, job.type, success};
+        completions.push_back(completion);
+    }
+
+    void drain(SIM900Bank& bank, uint32_t timeout) {
+        for(uint32_t start = millis(); (bank.queued() > 0 || bank.active() > 0) && millis() - start < timeout; yield())
+            bank.poll();
+    }
+}
+
+TEST(bank_spreads_jobs) {
+    VirtualModem first(115200), second(115200);
+    SIM900 firstSIM900(first), secondSIM900(second);
+
+    first.smsTime = second.smsTime = 2000000;
+    completions.clear();
+
+    SIM900Bank bank(onJob);
+    CHECK_EQUAL(0, bank.add(firstSIM900));
+    CHECK_EQUAL(1, bank.add(secondSIM900));
+
+    SIM900SMS messages[4];
+    for(uint8_t i = 0; i < 4; i++) {
+        messages[i].number = "+15551234567";
+        messages[i].message = "Bank";
+        CHECK(bank.sendSMS(messages[i]));
+    }
+
+    uint32_t start = millis();
+    drain(bank, 60000);
+
+    CHECK_EQUAL((size_t) 4, completions.size());
+    CHECK_EQUAL((size_t) 2, first.sent.size());
+    CHECK_EQUAL((size_t) 2, second.sent.size());
+    CHECK(millis() - start < 6000);
+
+    for(uint8_t i = 0; i < 4; i++) {
+        CHECK(messages[i].sent);
+        CHECK(messages[i].reference > 0);
+    }
+}
+
+TEST(bank_keeps_reference_of_long_message) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900Bank bank;
+    bank.add(sim900);
+
+    SIM900SMS sms;
+    sms.number = "+15551234567";
+    for(uint8_t i = 0; i < 150; i++)
+        sms.message += (char) ('a' + i % 26);
+
+    modem.nextReference = 77;
+    CHECK(bank.sendSMS(sms));
+    drain(bank, 10000);
+
+    CHECK(sms.sent);
+    CHECK_EQUAL(77, sms.reference);
+    CHECK_EQUAL((size_t) 150, modem.sent[0].text.size());
+}
+
+TEST(bank_runs_queries_and_commands) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    completions.clear();
+    SIM900Bank bank(onJob);
+    bank.add(sim900);
+
+    SIM900Batch batch;
+    batch.queries = SIM900_QUERY_SIGNAL;
+
+    CHECK(bank.query(batch));
+    CHECK(bank.submit("AT+GMI"));
+    drain(bank, 5000);
+
+    CHECK_EQUAL((size_t) 2, completions.size());
+    CHECK_EQUAL(SIM900_QUERY_SIGNAL, batch.received);
+    CHECK(strstr(bank.modem(0).lastResponse(), "SIMCOM_Ltd") != NULL);
+    CHECK_EQUAL((uint32_t) 2, bank.health(0).completed);
+}
+
+TEST(bank_backs_off_failing_modem) {
+    VirtualModem broken(115200), working(115200);
+    SIM900 brokenSIM900(broken), workingSIM900(working);
+
+    broken.fail("AT", VirtualModem::FAULT_ERROR, 100);
+    completions.clear();
+
+    SIM900Bank bank(onJob);
+    bank.add(brokenSIM900);
+    bank.add(workingSIM900);
+
+    for(uint8_t i = 0; i < 8; i++)
+        CHECK(bank.submit("AT"));
+    drain(bank, 10000);
+
+    SIM900BankHealth health = bank.health(0);
+    CHECK_EQUAL(SIM900_BANK_MAX_FAILURES, (int) health.failed);
+    CHECK(!health.available);
+    CHECK_EQUAL((uint32_t) 8 - SIM900_BANK_MAX_FAILURES, bank.health(1).completed);
+}
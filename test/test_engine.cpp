@@ -0,0 +1,235 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+namespace {
+    int commandStatus = -1;
+    std::string urcLine;
+    uint32_t reopenedBaud = 0;
+    VirtualModem* activeModem = NULL;
+
+    void onCommand(SIM900& sim900, SIM900CommandStatus status) {
+        (void) sim900;
+        commandStatus = status;
+    }
+
+    void onRing(const char* urc) {
+        urcLine = urc;
+    }
+
+    void reopen(uint32_t baud) {
+        reopenedBaud = baud;
+        activeModem->setHostBaudRate(baud);
+    }
+}
+
+TEST(handshake_answers_ok) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK(sim900.handshake());
+    CHECK_EQUAL(1U, modem.count("AT"));
+}
+
+TEST(handshake_fails_on_error) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("AT", VirtualModem::FAULT_ERROR);
+    CHECK(!sim900.handshake());
+    CHECK(sim900.handshake());
+}
+
+TEST(silent_command_times_out) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("AT", VirtualModem::FAULT_SILENCE);
+    uint32_t start = millis();
+
+    CHECK(!sim900.handshake());
+    CHECK_EQUAL(SIM900_COMMAND_TIMEOUT, sim900.status());
+    CHECK(millis() - start >= SIM900_RESPONSE_TIMEOUT);
+}
+
+TEST(garbled_answer_times_out) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("AT", VirtualModem::FAULT_GARBLE);
+    CHECK(!sim900.handshake());
+    CHECK(sim900.handshake());
+}
+
+TEST(truncated_answer_times_out) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("AT+CSQ", VirtualModem::FAULT_TRUNCATE);
+    sim900.signal();
+    CHECK_EQUAL(SIM900_COMMAND_TIMEOUT, sim900.status());
+}
+
+TEST(latency_delays_the_result) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.setLatency(300000);
+    uint32_t start = millis();
+
+    CHECK(sim900.handshake());
+    CHECK(millis() - start >= 300);
+}
+
+TEST(submit_completes_from_poll) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    commandStatus = -1;
+    CHECK(sim900.submit("AT", onCommand));
+    CHECK(sim900.isBusy());
+    CHECK(!sim900.submit("AT", onCommand));
+
+    for(uint32_t start = millis(); sim900.isBusy() && millis() - start < 1000; yield())
+        sim900.poll();
+
+    CHECK_EQUAL((int) SIM900_COMMAND_OK, commandStatus);
+}
+
+TEST(urc_is_dispatched_while_idle) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    urcLine.clear();
+    CHECK(sim900.onURC("RING", onRing));
+
+    modem.injectURC("RING", 1000);
+    for(uint32_t start = millis(); urcLine.empty() && millis() - start < 100; yield())
+        sim900.poll();
+
+    CHECK_TEXT("RING", urcLine);
+}
+
+TEST(urc_is_dispatched_during_command) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    urcLine.clear();
+    sim900.onURC("RING", onRing);
+
+    modem.on("AT+CSQ", [](VirtualModem& target, const std::string&) {
+        target.replyRaw("\r\nRING\r\n");
+        target.reply("+CSQ: 17,3\nOK", 1000);
+    });
+
+    SIM900Signal signal = sim900.signal();
+    CHECK_TEXT("RING", urcLine);
+    CHECK_EQUAL(17, signal.rssi);
+    CHECK_EQUAL(3, signal.bit_error_rate);
+}
+
+TEST(begin_waits_for_boot) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.boot(4000);
+    CHECK(sim900.begin(SIM900_READY_SMS));
+    CHECK_EQUAL((uint8_t) 0x1f, sim900.readiness());
+    CHECK(sim900.timeToReady() >= 3000);
+}
+
+TEST(begin_probes_a_running_modem) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK(sim900.begin(SIM900_READY_SMS, -1, 10000));
+    CHECK_EQUAL(1U, modem.count("AT+CPMS?"));
+}
+
+TEST(set_baud_rate_reopens_the_port) {
+    VirtualModem modem(9600);
+    SIM900 sim900(modem);
+
+    activeModem = &modem;
+    CHECK(sim900.setBaudRate(115200, reopen));
+    CHECK_EQUAL(115200U, modem.baudRate());
+    CHECK_EQUAL(115200U, reopenedBaud);
+}
+
+TEST(detect_baud_rate_finds_the_modem) {
+    VirtualModem modem(57600);
+    SIM900 sim900(modem);
+
+    activeModem = &modem;
+    modem.setHostBaudRate(9600);
+
+    CHECK_EQUAL(57600U, sim900.detectBaudRate(reopen));
+}
+
+TEST(slow_baud_rate_takes_longer) {
+    VirtualModem slow(9600);
+    SIM900 slowSIM900(slow);
+
+    uint32_t start = micros();
+    slowSIM900.manufacturer();
+    uint32_t slowTime = micros() - start;
+
+    VirtualModem fast(115200);
+    SIM900 fastSIM900(fast);
+
+    start = micros();
+    fastSIM900.manufacturer();
+    uint32_t fastTime = micros() - start;
+
+    CHECK(slowTime > fastTime * 5);
+}
+
+#ifdef SIM900_ENABLE_STATS
+TEST(stats_count_round_trips) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    sim900.resetStats();
+    sim900.handshake();
+    sim900.signal();
+    sim900.signal();
+
+    SIM900Stats stats;
+    sim900.statsSnapshot(stats);
+
+    bool found = false;
+    for(uint8_t i = 0; i < stats.family_count; i++)
+        if(strcmp(stats.families[i].name, "+CSQ") == 0) {
+            found = true;
+
+            CHECK_EQUAL(2, stats.families[i].calls);
+            CHECK_EQUAL((uint32_t) 2 * strlen("AT+CSQ\r\n"), stats.families[i].bytes_sent);
+        }
+
+    CHECK(found);
+}
+#endif
@@ -0,0 +1,314 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+namespace {
+    std::string sunk;
+    size_t uploaded = 0;
+
+    void onBody(const uint8_t* chunk, uint16_t length) {
+        sunk.append((const char*) chunk, length);
+    }
+
+    uint16_t uploadSource(uint8_t* buffer, uint16_t size) {
+        for(uint16_t i = 0; i < size; i++)
+            buffer[i] = (uint8_t) ('a' + (uploaded + i) % 26);
+
+        uploaded += size;
+        return size;
+    }
+
+    std::string pattern(size_t length) {
+        std::string result;
+        for(size_t i = 0; i < length; i++)
+            result += (char) ('a' + i % 26);
+
+        return result;
+    }
+
+    VirtualModem::HTTPReply echoServer(const VirtualModem::HTTPRequest& request) {
+        VirtualModem::HTTPReply reply;
+        reply.headers.push_back(std::make_pair(std::string("X-Method"), request.method));
+        reply.body = request.method + " " + request.path + " " + request.body;
+
+        return reply;
+    }
+
+    void connect(SIM900& sim900) {
+        SIM900APN apn;
+        apn.apn = "internet";
+        apn.username = apn.password = "";
+
+        CHECK(sim900.connectAPN(apn));
+        CHECK(sim900.enableGPRS());
+    }
+
+    SIM900HTTPRequest makeRequest(const char* method, const char* resource) {
+        SIM900HTTPRequest request;
+        request.method = method;
+        request.domain = "example.com";
+        request.resource = resource;
+        request.port = 80;
+        request.headers = NULL;
+        request.header_count = 0;
+        request.data = "";
+
+        return request;
+    }
+}
+
+TEST(request_needs_an_apn) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/"));
+
+    CHECK_EQUAL((uint16_t) -1, response.status);
+    CHECK(modem.requests.empty());
+}
+
+TEST(tcp_get_single_connection) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    modem.serverTime = 200000;
+    connect(sim900);
+
+    SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/index"));
+    CHECK_EQUAL(200, response.status);
+    CHECK_TEXT("GET /index ", response.data.c_str());
+    CHECK(response.ttfb >= 190 && response.ttfb <= 210);
+    CHECK(response.elapsed >= response.ttfb);
+
+    CHECK_EQUAL((size_t) 1, modem.requests.size());
+    CHECK_TEXT("example.com", modem.requests[0].header("Host"));
+    CHECK_EQUAL(1U, modem.count("AT+CIPCLOSE"));
+}
+
+TEST(tcp_post_with_data) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    connect(sim900);
+
+    SIM900HTTPHeader headers[1];
+    headers[0].key = "Content-Type";
+    headers[0].value = "text/plain";
+
+    SIM900HTTPRequest request = makeRequest("POST", "/submit");
+    request.data = "payload";
+    request.headers = headers;
+    request.header_count = 1;
+
+    SIM900HTTPResponse response = sim900.request(request);
+    CHECK_EQUAL(200, response.status);
+    CHECK_TEXT("POST /submit payload", response.data.c_str());
+    CHECK_TEXT("text/plain", modem.requests[0].header("Content-Type"));
+    CHECK_TEXT("X-Method", response.headers[0].key.c_str());
+}
+
+TEST(tcp_pool_reuses_connections) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    connect(sim900);
+    CHECK(sim900.enableConnectionPool());
+
+    for(uint8_t i = 0; i < 3; i++) {
+        SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/again"));
+        CHECK_EQUAL(200, response.status);
+        CHECK_TEXT("GET /again ", response.data.c_str());
+    }
+
+    CHECK_EQUAL(1U, modem.connectionsOpened);
+    CHECK_EQUAL(SIM900_CONNECTION_CONNECTED, sim900.connectionState(0));
+
+    CHECK(sim900.refreshConnections());
+    CHECK_EQUAL(SIM900_CONNECTION_CONNECTED, sim900.connectionState(0));
+    CHECK_EQUAL(SIM900_CONNECTION_CLOSED, sim900.connectionState(1));
+}
+
+TEST(tcp_chunked_response_into_sink) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = [](const VirtualModem::HTTPRequest&) {
+        VirtualModem::HTTPReply reply;
+        reply.body = pattern(3000);
+        reply.chunked = true;
+
+        return reply;
+    };
+
+    connect(sim900);
+    CHECK(sim900.enableConnectionPool());
+
+    sunk.clear();
+    SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/large"), onBody);
+
+    CHECK_EQUAL(200, response.status);
+    CHECK_EQUAL((unsigned) 0, response.data.length());
+    CHECK(sunk == pattern(3000));
+}
+
+TEST(tcp_streamed_upload) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = [](const VirtualModem::HTTPRequest& request) {
+        VirtualModem::HTTPReply reply;
+        reply.body = std::to_string(request.body.size());
+        reply.close = request.body != pattern(5000);
+
+        return reply;
+    };
+
+    connect(sim900);
+    uploaded = 0;
+
+    SIM900HTTPResponse response = sim900.request(makeRequest("PUT", "/upload"), uploadSource, 5000);
+    CHECK_EQUAL(200, response.status);
+    CHECK_TEXT("5000", response.data.c_str());
+    CHECK_EQUAL((size_t) 5000, uploaded);
+    CHECK(modem.count("AT+CIPSEND=") >= 4);
+}
+
+TEST(tcp_connection_failure) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    connect(sim900);
+    SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/"));
+
+    CHECK_EQUAL((uint16_t) -1, response.status);
+}
+
+TEST(builtin_get) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = [](const VirtualModem::HTTPRequest& request) {
+        VirtualModem::HTTPReply reply;
+        reply.body = pattern(1200);
+        reply.status = request.header("X-Token") == "secret" ? 200 : 403;
+
+        return reply;
+    };
+
+    connect(sim900);
+    sim900.setHTTPEngine(SIM900_HTTP_ENGINE_BUILTIN);
+
+    SIM900HTTPHeader headers[1];
+    headers[0].key = "X-Token";
+    headers[0].value = "secret";
+
+    SIM900HTTPRequest request = makeRequest("GET", "/builtin");
+    request.port = 8080;
+    request.headers = headers;
+    request.header_count = 1;
+
+    SIM900HTTPResponse response = sim900.request(request);
+    CHECK_EQUAL(200, response.status);
+    CHECK(std::string(response.data.c_str()) == pattern(1200));
+    CHECK_EQUAL(3U, modem.count("AT+HTTPREAD="));
+
+    CHECK_EQUAL((size_t) 1, modem.requests.size());
+    CHECK_EQUAL(8080, modem.requests[0].port);
+    CHECK_TEXT("/builtin", modem.requests[0].path);
+    CHECK_EQUAL(1U, modem.count("AT+HTTPTERM"));
+}
+
+TEST(builtin_streamed_post) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    connect(sim900);
+    sim900.setHTTPEngine(SIM900_HTTP_ENGINE_BUILTIN);
+
+    uploaded = 0;
+    SIM900HTTPResponse response = sim900.request(makeRequest("POST", "/up"), uploadSource, 3000);
+
+    CHECK_EQUAL(200, response.status);
+    CHECK(std::string(response.data.c_str()) == "POST /up " + pattern(3000));
+}
+
+TEST(builtin_recovers_a_stale_session) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    connect(sim900);
+    sim900.setHTTPEngine(SIM900_HTTP_ENGINE_BUILTIN);
+
+    modem.fail("AT+HTTPINIT", VirtualModem::FAULT_ERROR);
+    SIM900HTTPResponse response = sim900.request(makeRequest("GET", "/"));
+
+    CHECK_EQUAL(200, response.status);
+    CHECK_EQUAL(2U, modem.count("AT+HTTPINIT"));
+}
+
+#ifdef SIM900_ENABLE_STATS
+namespace {
+    uint32_t bytesSent(SIM900& sim900) {
+        SIM900Stats stats;
+        sim900.statsSnapshot(stats);
+
+        uint32_t total = 0;
+        for(uint8_t i = 0; i < stats.family_count; i++)
+            total += stats.families[i].bytes_sent;
+
+        return total;
+    }
+}
+
+TEST(stats_count_http_uploads) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.server = echoServer;
+    sim900.resetStats();
+    connect(sim900);
+
+    SIM900HTTPRequest request = makeRequest("POST", "/counted");
+    request.data = "inline body";
+
+    uploaded = 0;
+    CHECK_EQUAL(200, sim900.request(request).status);
+    CHECK_EQUAL(200, sim900.request(makeRequest("POST", "/streamed"), uploadSource, 2000).status);
+
+    sim900.setHTTPEngine(SIM900_HTTP_ENGINE_BUILTIN);
+    CHECK_EQUAL(200, sim900.request(request).status);
+    CHECK_EQUAL(200, sim900.request(makeRequest("POST", "/streamed"), uploadSource, 2000).status);
+
+    CHECK_EQUAL((uint32_t) modem.bytesFromHost(), bytesSent(sim900));
+}
+#endif
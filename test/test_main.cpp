@@ -0,0 +1,74 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+
+#include <vector>
+
+namespace {
+    struct Entry {
+        const char* name;
+        Test::Function function;
+    };
+
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> tests;
+        return tests;
+    }
+
+    unsigned failures = 0;
+}
+
+bool Test::add(const char* name, Function function) {
+    Entry entry = {name, function};
+    registry().push_back(entry);
+
+    return true;
+}
+
+void Test::fail(const char* file, int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, message.c_str());
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    int failed = 0;
+
+    for(size_t i = 0; i < registry().size(); i++) {
+        const Entry& test = registry()[i];
+        if(argc > 1 && std::string(argv[1]) != test.name)
+            continue;
+
+        unsigned before = failures;
+        test.function();
+
+        bool passed = failures == before;
+        printf("%s %s\n", passed ? "PASS" : "FAIL", test.name);
+
+        if(!passed)
+            failed++;
+    }
+
+    printf("%d of %d tests failed\n", failed, (int) registry().size());
+    return failed;
+}
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+#include <map>
+
+namespace {
+    std::map<int, std::string> listed;
+
+    void onEntry(uint8_t index, SIM900CardAccount account) {
+        listed[index] = account.name.c_str();
+    }
+
+    SIM900CardAccount account(const char* name, const char* number) {
+        SIM900CardAccount result;
+        result.name = name;
+        result.number = number;
+        result.numberType = static_cast<SIM900PhonebookType>(145);
+
+        return result;
+    }
+
+    void fill(VirtualModem& modem, int count) {
+        for(int i = 1; i <= count; i++) {
+            VirtualModem::Entry entry;
+            entry.number = "+1555" + std::to_string(1000000 + i);
+            entry.type = 145;
+            entry.name = "Contact " + std::to_string(i);
+
+            modem.phonebook[i] = entry;
+        }
+    }
+}
+
+TEST(save_and_retrieve_entry) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK(sim900.savePhonebook(3, account("Alice", "+15551112222")));
+    CHECK_TEXT("Alice", modem.phonebook[3].name);
+    CHECK_EQUAL(145, modem.phonebook[3].type);
+
+    SIM900CardAccount entry = sim900.retrievePhonebook(3);
+    CHECK_TEXT("Alice", entry.name.c_str());
+    CHECK_TEXT("+15551112222", entry.number.c_str());
+    CHECK_EQUAL(145, (int) entry.numberType);
+
+    CHECK(sim900.deletePhonebook(3));
+    CHECK(modem.phonebook.empty());
+}
+
+TEST(capacity_reports_usage) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    fill(modem, 12);
+    SIM900PhonebookCapacity capacity = sim900.phonebookCapacity();
+
+    CHECK_TEXT("SM", capacity.memoryType.c_str());
+    CHECK_EQUAL(12, capacity.used);
+    CHECK_EQUAL(250, capacity.max);
+}
+
+TEST(read_range_into_callback) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    fill(modem, 250);
+    modem.phonebook.erase(7);
+    modem.phonebookEntryTime = 5000;
+    listed.clear();
+
+    SIM900PhonebookReport report = sim900.readPhonebook(1, 250, onEntry);
+    CHECK(report.success);
+    CHECK_EQUAL(249, report.entries);
+    CHECK_EQUAL((size_t) 249, listed.size());
+    CHECK_TEXT("Contact 250", listed[250]);
+    CHECK(listed.find(7) == listed.end());
+    CHECK(report.elapsed >= 1250);
+}
+
+TEST(read_range_into_array) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    fill(modem, 5);
+    modem.phonebook.erase(2);
+
+    SIM900CardAccount accounts[4];
+    SIM900PhonebookReport report = sim900.readPhonebook(1, 4, accounts, 4);
+
+    CHECK(report.success);
+    CHECK_EQUAL(3, report.entries);
+    CHECK_TEXT("Contact 1", accounts[0].name.c_str());
+    CHECK_EQUAL((unsigned) 0, accounts[1].name.length());
+    CHECK_TEXT("+15551000004", accounts[3].number.c_str());
+}
+
+TEST(sync_writes_only_differences) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    fill(modem, 3);
+    modem.phonebook[10] = modem.phonebook[1];
+
+    SIM900CardAccount desired[3] = {
+        account("Contact 1", "+15551000001"),
+        account("Changed", "+15551000002"),
+        account("", "")
+    };
+    desired[2].number = F("");
+
+    modem.clearCommands();
+    SIM900PhonebookReport report = sim900.syncPhonebook(desired, 3);
+
+    CHECK(report.success);
+    CHECK_EQUAL(3, report.entries);
+    CHECK_TEXT("Changed", modem.phonebook[2].name);
+    CHECK(modem.phonebook.find(3) == modem.phonebook.end());
+    CHECK(modem.phonebook.find(10) == modem.phonebook.end());
+    CHECK_EQUAL(3U, modem.count("AT+CPBW="));
+}
+
+TEST(find_scans_for_number) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    fill(modem, 20);
+    CHECK_EQUAL(17, sim900.findPhonebook("15551000017"));
+    CHECK_EQUAL(-1, sim900.findPhonebook("+15559999999"));
+}
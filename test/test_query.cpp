@@ -0,0 +1,196 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+namespace {
+    int batchResult = -1;
+
+    void onBatch(bool success) {
+        batchResult = success ? 1 : 0;
+    }
+}
+
+TEST(module_information) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK_TEXT("SIMCOM_Ltd", sim900.manufacturer().c_str());
+    CHECK_TEXT("1137B12SIM900M64_ST", sim900.softwareRelease().c_str());
+    CHECK_TEXT("013950001234567", sim900.imei().c_str());
+    CHECK_TEXT("SIMCOM_SIM900", sim900.chipModel().c_str());
+    CHECK_TEXT("SIM900", sim900.chipName().c_str());
+}
+
+TEST(ip_address_completes_on_its_line) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    uint32_t start = millis();
+    CHECK_TEXT("10.0.0.2", sim900.ipAddress().c_str());
+    CHECK(millis() - start < 100);
+}
+
+TEST(card_number) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900CardAccount account = sim900.cardNumber();
+    CHECK_TEXT("+15550000000", account.number.c_str());
+    CHECK_EQUAL(145, account.type);
+    CHECK_EQUAL(7, account.speed);
+}
+
+TEST(network_operator) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900Operator networkOperator = sim900.networkOperator();
+    CHECK_TEXT("Virtual Mobile", networkOperator.name.c_str());
+}
+
+TEST(rtc_round_trip) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900RTC time;
+    time.year = 25;
+    time.month = 7;
+    time.day = 4;
+    time.hour = 9;
+    time.minute = 5;
+    time.second = 3;
+    time.gmt = 8;
+
+    CHECK(sim900.updateRtc(time));
+    CHECK_TEXT("25/07/04,09:05:03+08", modem.clock);
+
+    SIM900RTC read = sim900.rtc();
+    CHECK_EQUAL(25, read.year);
+    CHECK_EQUAL(7, read.month);
+    CHECK_EQUAL(4, read.day);
+    CHECK_EQUAL(9, read.hour);
+    CHECK_EQUAL(5, read.minute);
+    CHECK_EQUAL(3, read.second);
+    CHECK_EQUAL(8, read.gmt);
+}
+
+TEST(rtc_update_without_heap) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900RTC time;
+    time.year = 9;
+    time.month = 12;
+    time.day = 31;
+    time.hour = 23;
+    time.minute = 59;
+    time.second = 0;
+    time.gmt = -20;
+
+    size_t used = ArduinoShim::heapUsed();
+    ArduinoShim::resetHeapPeak();
+
+    CHECK(sim900.updateRtc(time));
+    CHECK_EQUAL(used, ArduinoShim::heapPeak());
+    CHECK_TEXT("09/12/31,23:59:00-20", modem.clock);
+}
+
+TEST(dial_results) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK_EQUAL(SIM900_DIAL_RESULT_OK, sim900.dialUp("5551234"));
+    modem.dialResult = "BUSY";
+    CHECK_EQUAL(SIM900_DIAL_RESULT_BUSY, sim900.redialUp());
+    CHECK(sim900.hangUp());
+}
+
+TEST(batch_query_in_one_line) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.rssi = 23;
+    modem.phonebook[1].number = "+15551234567";
+
+    SIM900Batch batch;
+    batch.queries = SIM900_QUERY_SIGNAL | SIM900_QUERY_OPERATOR |
+        SIM900_QUERY_PHONEBOOK_CAPACITY | SIM900_QUERY_RTC;
+
+    CHECK(sim900.query(batch));
+    CHECK_EQUAL(1U, modem.count("AT+CSQ;+COPS?;+CPBS?;+CCLK?"));
+    CHECK_EQUAL(batch.queries, batch.received);
+
+    CHECK_EQUAL(23, batch.signal.rssi);
+    CHECK_TEXT("Virtual Mobile", batch.networkOperator.name.c_str());
+    CHECK_EQUAL(1, batch.phonebookCapacity.used);
+    CHECK_EQUAL(250, batch.phonebookCapacity.max);
+    CHECK_EQUAL(24, batch.rtc.year);
+    CHECK_EQUAL(5, batch.rtc.second);
+}
+
+TEST(batch_query_from_poll) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900Batch batch;
+    batch.queries = SIM900_QUERY_OPERATOR | SIM900_QUERY_RTC;
+    batchResult = -1;
+
+    CHECK(sim900.query(batch, onBatch));
+    for(uint32_t start = millis(); sim900.isBusy() && millis() - start < 1000; yield())
+        sim900.poll();
+
+    CHECK_EQUAL(1, batchResult);
+    CHECK_EQUAL(1U, modem.count("AT+COPS?;+CCLK?"));
+    CHECK_EQUAL(batch.queries, batch.received);
+}
+
+TEST(blocking_batch_query_waits_for_pending_command) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.setLatency("AT+GMI", 500000);
+    CHECK(sim900.submit("AT+GMI"));
+
+    SIM900Batch batch;
+    batch.queries = SIM900_QUERY_SIGNAL;
+
+    CHECK(sim900.query(batch));
+    CHECK_EQUAL(SIM900_QUERY_SIGNAL, batch.received);
+}
+
+TEST(batch_query_error) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900Batch batch;
+    batch.queries = SIM900_QUERY_SIGNAL;
+
+    modem.fail("AT+CSQ", VirtualModem::FAULT_ERROR);
+    CHECK(!sim900.query(batch));
+    CHECK_EQUAL(0, batch.received);
+}
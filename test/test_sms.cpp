@@ -0,0 +1,252 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "test.h"
+#include "virtual_modem.h"
+
+#include <sim900.h>
+
+#include <vector>
+
+namespace {
+    int sendResult = -1;
+    std::vector<SIM900ReceivedSMS> received;
+
+    void onSent(bool success) {
+        sendResult = success ? 1 : 0;
+    }
+
+    void onReceived(SIM900ReceivedSMS sms) {
+        received.push_back(sms);
+    }
+
+    VirtualModem::Message message(int index, const std::string& status, const std::string& text) {
+        VirtualModem::Message result;
+        result.index = index;
+        result.status = status;
+        result.number = "+15551234567";
+        result.timestamp = "24/03/04,05:06:07+32";
+        result.text = text;
+
+        return result;
+    }
+}
+
+TEST(send_sms_switches_to_text_mode) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    CHECK(sim900.sendSMS("+15557654321", "Hello"));
+    CHECK_EQUAL(1, modem.messageFormat);
+    CHECK_EQUAL((size_t) 1, modem.sent.size());
+    CHECK_TEXT("+15557654321", modem.sent[0].number);
+    CHECK_TEXT("Hello", modem.sent[0].text);
+
+    CHECK(sim900.sendSMS("+15557654321", "Again"));
+    CHECK_EQUAL(1U, modem.count("AT+CMGF=1"));
+}
+
+TEST(send_sms_reports_network_errors) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("<SMS>", VirtualModem::FAULT_ERROR);
+    CHECK(!sim900.sendSMS("+15557654321", "Hello"));
+    CHECK(modem.sent.empty());
+}
+
+TEST(send_sms_cancels_a_refused_prompt) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.fail("AT+CMGS=", VirtualModem::FAULT_SILENCE);
+    CHECK(!sim900.sendSMS("+15557654321", "Hello"));
+    CHECK(sim900.sendSMS("+15557654321", "Hello"));
+    CHECK_EQUAL((size_t) 1, modem.sent.size());
+}
+
+TEST(async_send_sms_completes_from_poll) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.smsTime = 3000000;
+    sendResult = -1;
+
+    CHECK(sim900.sendSMS("+15557654321", "Hello", onSent));
+    for(uint32_t start = millis(); sim900.isBusy() && millis() - start < 10000; yield())
+        sim900.poll();
+
+    CHECK_EQUAL(1, sendResult);
+    CHECK_EQUAL((size_t) 1, modem.sent.size());
+    CHECK_EQUAL(1, sim900.smsReference());
+}
+
+TEST(async_send_sms_keeps_reference_after_echo) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.nextReference = 201;
+    CHECK(sim900.sendSMS("+15557654321", std::string(160, 'x').c_str(), onSent));
+    CHECK(!sim900.sendSMS("+15557654321", "Busy", onSent));
+
+    for(uint32_t start = millis(); sim900.isBusy() && millis() - start < 10000; yield())
+        sim900.poll();
+
+    CHECK_EQUAL(SIM900_COMMAND_OK, sim900.status());
+    CHECK_EQUAL(201, sim900.smsReference());
+
+    modem.fail("<SMS>", VirtualModem::FAULT_ERROR);
+    CHECK(!sim900.sendSMS("+15557654321", "Rejected"));
+    CHECK_EQUAL(-1, sim900.smsReference());
+}
+
+TEST(blocking_send_sms_waits_for_pending_command) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.setLatency("AT+CSQ", 500000);
+    CHECK(sim900.signal(NULL));
+
+    CHECK(sim900.sendSMS("+15557654321", "After signal"));
+    CHECK_EQUAL((size_t) 1, modem.sent.size());
+}
+
+TEST(bulk_sms_collects_references) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    SIM900SMS messages[3];
+    for(uint8_t i = 0; i < 3; i++) {
+        messages[i].number = "+1555000000";
+        messages[i].number += (int) i;
+        messages[i].message = "Bulk message";
+    }
+
+    modem.nextReference = 40;
+    modem.fail("<SMS>", VirtualModem::FAULT_ERROR);
+
+    SIM900SMSReport report = sim900.sendSMS(messages, 3);
+    CHECK_EQUAL(2, report.sent);
+    CHECK_EQUAL(1, report.failed);
+
+    CHECK(!messages[0].sent);
+    CHECK(messages[1].sent);
+    CHECK_EQUAL(40, messages[1].reference);
+    CHECK_EQUAL(41, messages[2].reference);
+}
+
+TEST(read_sms_lists_messages) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.inbox.push_back(message(1, "REC READ", "First"));
+    modem.inbox.push_back(message(2, "REC UNREAD", "Second\nline"));
+    received.clear();
+
+    CHECK_EQUAL(2, sim900.readSMS(onReceived));
+    CHECK_EQUAL((size_t) 2, received.size());
+
+    if(received.size() == 2) {
+        CHECK_EQUAL(1, received[0].index);
+        CHECK_TEXT("REC READ", received[0].status.c_str());
+        CHECK_TEXT("+15551234567", received[0].number.c_str());
+        CHECK_TEXT("First", received[0].message.c_str());
+        CHECK_EQUAL(4, received[0].timestamp.day);
+        CHECK_EQUAL(7, received[0].timestamp.second);
+        CHECK_TEXT("Second\nline", received[1].message.c_str());
+    }
+}
+
+TEST(read_sms_keeps_result_like_lines_of_body) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.inbox.push_back(message(1, "REC READ", "Reply with\nOK\nor\nERROR"));
+    modem.inbox.push_back(message(2, "REC READ", "RING\n+CMT: \"+1555\""));
+    received.clear();
+
+    CHECK_EQUAL(2, sim900.readSMS(onReceived));
+    CHECK_EQUAL((size_t) 2, received.size());
+
+    if(received.size() == 2) {
+        CHECK_TEXT("Reply with\nOK\nor\nERROR", received[0].message.c_str());
+        CHECK_TEXT("RING\n+CMT: \"+1555\"", received[1].message.c_str());
+    }
+}
+
+TEST(read_sms_unread_and_drain) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    modem.inbox.push_back(message(1, "REC READ", "Old"));
+    modem.inbox.push_back(message(2, "REC UNREAD", "New"));
+    received.clear();
+
+    CHECK_EQUAL(1, sim900.readSMS(onReceived, true, true));
+    CHECK_EQUAL((size_t) 1, received.size());
+    CHECK(modem.inbox.empty());
+    CHECK_EQUAL(0, sim900.readSMS(onReceived, true));
+}
+
+TEST(read_sms_with_empty_storage) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    received.clear();
+    CHECK_EQUAL(0, sim900.readSMS(onReceived));
+    CHECK(received.empty());
+}
+
+#ifdef SIM900_ENABLE_STATS
+namespace {
+    uint32_t bytesSent(SIM900& sim900) {
+        SIM900Stats stats;
+        sim900.statsSnapshot(stats);
+
+        uint32_t total = 0;
+        for(uint8_t i = 0; i < stats.family_count; i++)
+            total += stats.families[i].bytes_sent;
+
+        return total;
+    }
+}
+
+TEST(stats_count_sms_text) {
+    VirtualModem modem(115200);
+    SIM900 sim900(modem);
+
+    sim900.resetStats();
+    CHECK(sim900.sendSMS("+15557654321", "Counted text"));
+    CHECK(sim900.sendSMS("+15557654321", "Counted again", NULL));
+    for(uint32_t start = millis(); sim900.isBusy() && millis() - start < 10000; yield())
+        sim900.poll();
+
+    SIM900SMS messages[2];
+    messages[0].number = messages[1].number = "+15557654321";
+    messages[0].message = "First of batch";
+    messages[1].message = "Second of batch";
+    CHECK_EQUAL(2, sim900.sendSMS(messages, 2).sent);
+
+    CHECK_EQUAL((uint32_t) modem.bytesFromHost(), bytesSent(sim900));
+}
+#endif
@@ -0,0 +1,1171 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "virtual_modem.h"
+
+#include <stdio.h>
+
+/// Number of bytes the serial port of the host buffers before a write blocks.
+#define VIRTUAL_MODEM_TX_BUFFER 64
+
+/// Size in bytes of the data frames of a TCP link in multi-connection mode.
+#define VIRTUAL_MODEM_FRAME_SIZE 1460
+
+std::string VirtualModem::HTTPRequest::header(const std::string& key) const {
+    for(size_t i = 0; i < this->headers.size(); i++)
+        if(strcasecmp(this->headers[i].first.c_str(), key.c_str()) == 0)
+            return this->headers[i].second;
+
+    return "";
+}
+
+VirtualModem::VirtualModem(uint32_t _baud):baud(_baud), hostBaud(_baud) {
+    this->wireFree = this->hostFree = ArduinoShim::now();
+}
+
+uint64_t VirtualModem::byteTime() const {
+    return this->baud == 0 ? 0 : 10000000ULL / this->baud;
+}
+
+bool VirtualModem::understood() const {
+    return this->baud == this->hostBaud;
+}
+
+bool VirtualModem::startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+std::vector<std::string> VirtualModem::parameters(const std::string& text) {
+    std::vector<std::string> result;
+    std::string current;
+    bool quoted = false;
+
+    for(size_t i = 0; i < text.size(); i++) {
+        char ch = text[i];
+
+        if(ch == '"')
+            quoted = !quoted;
+        else if(ch == ',' && !quoted) {
+            result.push_back(current);
+            current.clear();
+        }
+        else current += ch;
+    }
+
+    result.push_back(current);
+    return result;
+}
+
+void VirtualModem::schedule(uint64_t time, const std::string& bytes, std::function<void()> action) {
+    Event event;
+    event.bytes = bytes;
+    event.action = action;
+
+    this->events.insert(std::make_pair(time, event));
+}
+
+void VirtualModem::pump() {
+    uint64_t now = ArduinoShim::now();
+
+    while(!this->events.empty() && this->events.begin()->first <= now) {
+        uint64_t time = this->events.begin()->first;
+        Event event = this->events.begin()->second;
+        this->events.erase(this->events.begin());
+
+        for(size_t i = 0; i < event.bytes.size(); i++) {
+            uint64_t ready = (time > this->wireFree ? time : this->wireFree) + this->byteTime();
+            uint8_t data = (uint8_t) event.bytes[i];
+
+            this->wire.push_back(std::make_pair(ready, this->understood() ? data : (uint8_t) (data | 0x80)));
+            this->wireFree = ready;
+            this->toHost++;
+        }
+
+        if(event.action)
+            event.action();
+    }
+
+    while(this->readyCount < this->wire.size() && this->wire[this->readyCount].first <= now)
+        this->readyCount++;
+}
+
+int VirtualModem::available() {
+    this->pump();
+    return (int) this->readyCount;
+}
+
+int VirtualModem::read() {
+    this->pump();
+    if(this->readyCount == 0)
+        return -1;
+
+    uint8_t data = this->wire.front().second;
+    this->wire.pop_front();
+    this->readyCount--;
+
+    return data;
+}
+
+int VirtualModem::peek() {
+    this->pump();
+    return this->readyCount == 0 ? -1 : this->wire.front().second;
+}
+
+size_t VirtualModem::write(uint8_t data) {
+    uint64_t now = ArduinoShim::now();
+    uint64_t arrival = (now > this->hostFree ? now : this->hostFree) + this->byteTime();
+
+    this->hostFree = arrival;
+    this->fromHost++;
+
+    uint64_t backlog = VIRTUAL_MODEM_TX_BUFFER * this->byteTime();
+    if(arrival > now + backlog)
+        ArduinoShim::advanceTo(arrival - backlog);
+
+    if(this->powered && this->understood() && arrival >= this->readyAt)
+        this->receiveByte(data, arrival);
+
+    return 1;
+}
+
+size_t VirtualModem::write(const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++)
+        this->write(data[i]);
+
+    return size;
+}
+
+void VirtualModem::flush() {
+    ArduinoShim::advanceTo(this->hostFree);
+}
+
+uint64_t VirtualModem::nextEvent() {
+    this->pump();
+
+    uint64_t next = UINT64_MAX;
+    if(!this->events.empty())
+        next = this->events.begin()->first;
+
+    if(this->readyCount < this->wire.size() && this->wire[this->readyCount].first < next)
+        next = this->wire[this->readyCount].first;
+
+    return next;
+}
+
+void VirtualModem::setBaudRate(uint32_t _baud) {
+    this->baud = this->hostBaud = _baud;
+}
+
+void VirtualModem::setHostBaudRate(uint32_t _baud) {
+    this->hostBaud = _baud;
+}
+
+uint32_t VirtualModem::baudRate() const {
+    return this->baud;
+}
+
+void VirtualModem::setLatency(uint32_t micros) {
+    this->latency = micros;
+}
+
+void VirtualModem::setLatency(const std::string& prefix, uint32_t micros) {
+    this->latencies.push_back(std::make_pair(prefix, micros));
+}
+
+void VirtualModem::on(const std::string& prefix, Handler handler) {
+    Script script;
+    script.prefix = prefix;
+    script.handler = handler;
+
+    this->scripts.push_back(script);
+}
+
+void VirtualModem::on(const std::string& prefix, const std::string& lines) {
+    this->on(prefix, [lines](VirtualModem& modem, const std::string&) {
+        modem.reply(lines);
+    });
+}
+
+void VirtualModem::fail(const std::string& prefix, Fault fault, unsigned count) {
+    Failure failure;
+    failure.prefix = prefix;
+    failure.fault = fault;
+    failure.count = count;
+
+    this->failures.push_back(failure);
+}
+
+bool VirtualModem::takeFault(const std::string& command, Fault& fault) {
+    for(size_t i = 0; i < this->failures.size(); i++) {
+        Failure& failure = this->failures[i];
+
+        if(failure.count > 0 && startsWith(command, failure.prefix)) {
+            failure.count--;
+            fault = failure.fault;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void VirtualModem::reply(const std::string& lines, uint32_t delay) {
+    std::string bytes = "\r\n";
+
+    for(size_t i = 0; i < lines.size(); i++) {
+        if(lines[i] == '\n')
+            bytes += '\r';
+
+        bytes += lines[i];
+    }
+
+    this->replyRaw(bytes + "\r\n", delay);
+}
+
+void VirtualModem::replyRaw(const std::string& bytes, uint32_t delay) {
+    this->answer.push_back(std::make_pair(this->answerTime + delay, bytes));
+}
+
+void VirtualModem::injectURC(const std::string& line, uint32_t delay) {
+    this->inject("\r\n" + line + "\r\n", delay);
+}
+
+void VirtualModem::inject(const std::string& bytes, uint32_t delay) {
+    this->schedule(ArduinoShim::now() + delay, bytes);
+}
+
+void VirtualModem::powerOff() {
+    this->powered = false;
+    this->events.clear();
+
+    this->echo = true;
+    this->messageFormat = 0;
+    this->mode = MODE_COMMAND;
+    this->line.clear();
+
+    this->multiConnection = false;
+    for(uint8_t i = 0; i < 8; i++)
+        this->links[i] = Link();
+
+    this->bearerOpen = this->httpInitialised = false;
+}
+
+void VirtualModem::boot(uint32_t milliseconds) {
+    static const char* const stages[] = {
+        "RDY", "+CFUN: 1", "+CPIN: READY", "Call Ready", "SMS Ready"
+    };
+
+    uint64_t step = (uint64_t) milliseconds * 1000 / 5;
+
+    this->powerOff();
+    this->powered = true;
+    this->readyAt = ArduinoShim::now() + step;
+
+    for(uint8_t i = 0; i < 5; i++)
+        this->schedule(ArduinoShim::now() + step * (i + 1), "\r\n" + std::string(stages[i]) + "\r\n");
+}
+
+const std::vector<std::string>& VirtualModem::commands() const {
+    return this->received;
+}
+
+unsigned VirtualModem::count(const std::string& prefix) const {
+    unsigned total = 0;
+
+    for(size_t i = 0; i < this->received.size(); i++)
+        if(startsWith(this->received[i], prefix))
+            total++;
+
+    return total;
+}
+
+void VirtualModem::clearCommands() {
+    this->received.clear();
+}
+
+uint64_t VirtualModem::bytesFromHost() const {
+    return this->fromHost;
+}
+
+uint64_t VirtualModem::bytesToHost() const {
+    return this->toHost;
+}
+
+void VirtualModem::receiveByte(uint8_t data, uint64_t time) {
+    bool lineFeed = this->commandEnded && data == '\n';
+    this->commandEnded = false;
+
+    if(lineFeed)
+        return;
+
+    switch(this->mode) {
+        case MODE_COMMAND:
+            if(data == '\r') {
+                std::string command = this->line;
+                this->line.clear();
+                this->commandEnded = true;
+
+                if(!command.empty())
+                    this->handleCommand(command, time);
+            }
+            else if(data != '\n' && data != 0x1a && data != 0x1b)
+                this->line += (char) data;
+            break;
+
+        case MODE_SMS_TEXT:
+            if(data == 0x1a || data == 0x1b)
+                this->handleSMSText(time, data == 0x1b);
+            else this->data += (char) data;
+            break;
+
+        case MODE_SEND_DATA:
+            this->data += (char) data;
+            if(this->data.size() == this->dataExpected)
+                this->handleSendData(time);
+            break;
+
+        case MODE_HTTP_DATA:
+            this->data += (char) data;
+            if(this->data.size() == this->dataExpected)
+                this->handleHTTPData(time);
+            break;
+    }
+}
+
+void VirtualModem::handleCommand(const std::string& command, uint64_t time) {
+    this->received.push_back(command);
+
+    if(this->echo)
+        this->schedule(time, command + "\r");
+
+    uint32_t delay = this->latency;
+    for(size_t i = 0; i < this->latencies.size(); i++)
+        if(startsWith(command, this->latencies[i].first))
+            delay = this->latencies[i].second;
+
+    this->answerTime = time + delay;
+    this->answer.clear();
+
+    Fault fault;
+    bool faulty = this->takeFault(command, fault);
+
+    if(faulty && fault == FAULT_SILENCE)
+        return;
+
+    if(faulty && fault == FAULT_ERROR) {
+        this->reply("ERROR");
+        this->sendAnswer(NULL);
+
+        return;
+    }
+
+    bool scripted = false;
+    for(size_t i = this->scripts.size(); i > 0 && !scripted; i--)
+        if(startsWith(command, this->scripts[i - 1].prefix)) {
+            this->scripts[i - 1].handler(*this, command);
+            scripted = true;
+        }
+
+    if(!scripted)
+        this->runDefault(command);
+
+    this->sendAnswer(faulty ? &fault : NULL);
+}
+
+void VirtualModem::sendAnswer(const Fault* fault) {
+    std::vector<std::pair<uint64_t, std::string>> parts;
+    parts.swap(this->answer);
+
+    if(fault != NULL && *fault == FAULT_GARBLE)
+        for(size_t i = 0; i < parts.size(); i++)
+            for(size_t j = 0; j < parts[i].second.size(); j++)
+                if(isalpha((unsigned char) parts[i].second[j]) || parts[i].second[j] == '>')
+                    parts[i].second[j] = '#';
+
+    if(fault != NULL && *fault == FAULT_TRUNCATE) {
+        size_t total = 0;
+        for(size_t i = 0; i < parts.size(); i++)
+            total += parts[i].second.size();
+
+        size_t keep = total / 2;
+        for(size_t i = 0; i < parts.size(); i++) {
+            if(parts[i].second.size() > keep)
+                parts[i].second.resize(keep);
+
+            keep -= parts[i].second.size();
+        }
+    }
+
+    uint64_t last = this->answerTime;
+    for(size_t i = 0; i < parts.size(); i++) {
+        this->schedule(parts[i].first, parts[i].second);
+
+        if(parts[i].first > last)
+            last = parts[i].first;
+    }
+
+    if(this->pendingBaud != 0) {
+        uint32_t rate = this->pendingBaud;
+        this->pendingBaud = 0;
+
+        this->schedule(last, "", [this, rate]() {
+            this->baud = rate;
+        });
+    }
+}
+
+void VirtualModem::runDefault(const std::string& command) {
+    this->resultDelay = 0;
+
+    switch(this->execute(command)) {
+        case RESULT_OK:
+            this->reply("OK", this->resultDelay);
+            break;
+
+        case RESULT_ERROR:
+            this->reply("ERROR", this->resultDelay);
+            break;
+
+        case RESULT_SENT:
+            break;
+    }
+}
+
+int VirtualModem::execute(const std::string& command) {
+    if(!startsWith(command, "AT+"))
+        return this->executeBasic(command);
+
+    std::vector<std::string> chain;
+    std::string current;
+    bool quoted = false;
+
+    for(size_t i = 0; i < command.size(); i++) {
+        if(command[i] == '"')
+            quoted = !quoted;
+
+        if(command[i] == ';' && !quoted) {
+            chain.push_back(current);
+            current = "AT";
+        }
+        else current += command[i];
+    }
+
+    if(current != "AT")
+        chain.push_back(current);
+
+    if(chain.size() == 1)
+        return this->executeBasic(chain[0]);
+
+    for(size_t i = 0; i < chain.size(); i++)
+        if(this->executeBasic(chain[i]) != RESULT_OK)
+            return RESULT_ERROR;
+
+    return RESULT_OK;
+}
+
+int VirtualModem::executeBasic(const std::string& command) {
+    char text[64];
+
+    if(command == "AT" || command == "AT&W" || command == "ATH" ||
+        startsWith(command, "AT+CPIN=") || startsWith(command, "AT+CENG=") ||
+        command == "AT+CGATT=1" || startsWith(command, "AT+CSTT=") ||
+        command == "AT+CIICR" || startsWith(command, "AT+SAPBR=3,"))
+        return RESULT_OK;
+
+    if(command == "ATE0" || command == "ATE1") {
+        this->echo = command == "ATE1";
+        return RESULT_OK;
+    }
+
+    if(command == "ATI") {
+        this->reply("SIM900 R11.0");
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+IPR=")) {
+        this->pendingBaud = (uint32_t) strtoul(command.c_str() + 7, NULL, 10);
+        return this->pendingBaud != 0 ? RESULT_OK : RESULT_ERROR;
+    }
+
+    if(startsWith(command, "ATD") || command == "ATA") {
+        this->reply(this->dialResult);
+        return RESULT_SENT;
+    }
+
+    if(command == "AT+CFUN?") {
+        this->reply("+CFUN: 1");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CPIN?") {
+        this->reply("+CPIN: READY");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CCALR?") {
+        this->reply("+CCALR: 1");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CPMS?") {
+        int used = (int) this->inbox.size();
+
+        snprintf(text, sizeof(text), "+CPMS: \"SM\",%d,30,\"SM\",%d,30,\"SM\",%d,30", used, used, used);
+        this->reply(text);
+
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CSQ") {
+        snprintf(text, sizeof(text), "+CSQ: %d,%d", this->rssi, this->bitErrorRate);
+        this->reply(text);
+
+        return RESULT_OK;
+    }
+
+    if(command == "AT+COPS?") {
+        this->reply("+COPS: 0,0,\"" + this->operatorName + "\"");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CNUM") {
+        this->reply("+CNUM: \"\",\"" + this->ownNumber + "\",145,7,4");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CCLK?") {
+        this->reply("+CCLK: \"" + this->clock + "\"");
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CCLK=")) {
+        static const char pattern[] = "\"00/00/00,00:00:00+00\"";
+        std::string value = command.substr(8);
+
+        if(value.size() != sizeof(pattern) - 1)
+            return RESULT_ERROR;
+
+        for(size_t i = 0; i < value.size(); i++) {
+            bool digit = pattern[i] == '0';
+
+            if(digit ? !isdigit((unsigned char) value[i]) :
+                pattern[i] == '+' ? value[i] != '+' && value[i] != '-' : value[i] != pattern[i])
+                return RESULT_ERROR;
+        }
+
+        this->clock = value.substr(1, value.size() - 2);
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CMGF=")) {
+        this->messageFormat = atoi(command.c_str() + 8);
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CMGS=")) {
+        if(this->messageFormat != 1)
+            return RESULT_ERROR;
+
+        this->smsNumber = parameters(command.substr(8))[0];
+        this->mode = MODE_SMS_TEXT;
+        this->data.clear();
+
+        this->replyRaw("\r\n> ");
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+CMGL=")) {
+        if(this->messageFormat != 1)
+            return RESULT_ERROR;
+
+        this->executeListSMS(parameters(command.substr(8))[0]);
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CMGDA=")) {
+        std::string kind = parameters(command.substr(9))[0];
+
+        if(this->messageFormat != 1 || (kind != "DEL READ" && kind != "DEL ALL"))
+            return RESULT_ERROR;
+
+        std::vector<Message> kept;
+        for(size_t i = 0; i < this->inbox.size(); i++)
+            if(kind == "DEL READ" && this->inbox[i].status != "REC READ")
+                kept.push_back(this->inbox[i]);
+
+        this->inbox.swap(kept);
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CPBS?") {
+        snprintf(text, sizeof(text), "+CPBS: \"SM\",%d,%d", (int) this->phonebook.size(), this->phonebookSize);
+        this->reply(text);
+
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CPBR=")) {
+        std::vector<std::string> range = parameters(command.substr(8));
+        int first = atoi(range[0].c_str());
+        int last = range.size() > 1 ? atoi(range[1].c_str()) : first;
+
+        if(first < 1 || last > this->phonebookSize || first > last)
+            return RESULT_ERROR;
+
+        uint32_t delay = 0;
+        for(int index = first; index <= last; index++) {
+            std::map<int, Entry>::const_iterator entry = this->phonebook.find(index);
+            delay += this->phonebookEntryTime;
+
+            if(entry == this->phonebook.end())
+                continue;
+
+            snprintf(text, sizeof(text), "+CPBR: %d,\"", index);
+            this->reply(text + entry->second.number + "\"," + std::to_string(entry->second.type) +
+                ",\"" + entry->second.name + "\"", delay);
+        }
+
+        this->resultDelay = delay;
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CPBW=")) {
+        std::vector<std::string> fields = parameters(command.substr(8));
+        int index = atoi(fields[0].c_str());
+
+        if(index < 1 || index > this->phonebookSize)
+            return RESULT_ERROR;
+
+        if(fields.size() == 1) {
+            this->phonebook.erase(index);
+            return RESULT_OK;
+        }
+
+        if(fields.size() < 4)
+            return RESULT_ERROR;
+
+        Entry entry;
+        entry.number = fields[1];
+        entry.type = atoi(fields[2].c_str());
+        entry.name = fields[3];
+
+        if(entry.type == 0)
+            entry.type = entry.number.compare(0, 1, "+") == 0 ? 145 : 129;
+
+        this->phonebook[index] = entry;
+        return RESULT_OK;
+    }
+
+    if(command == "AT+GMI") {
+        this->reply("SIMCOM_Ltd");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+GMR") {
+        this->reply("Revision:1137B12SIM900M64_ST");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+GSN") {
+        this->reply("013950001234567");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+GMM") {
+        this->reply("SIMCOM_SIM900");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+GOI") {
+        this->reply("SIM900");
+        return RESULT_OK;
+    }
+
+    if(command == "AT+CIFSR") {
+        this->reply(this->ipAddress);
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+CIPMUX=")) {
+        for(uint8_t i = 0; i < 8; i++)
+            if(this->links[i].open)
+                return RESULT_ERROR;
+
+        this->multiConnection = command == "AT+CIPMUX=1";
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+CIPSTART=")) {
+        this->executeStartConnection(command.substr(12));
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+CIPSEND=")) {
+        std::vector<std::string> fields = parameters(command.substr(11));
+        int link = this->multiConnection ? atoi(fields[0].c_str()) : 0;
+        size_t length = (size_t) atoi(fields.back().c_str());
+
+        if(link < 0 || link > 7 || !this->links[link].open || length == 0 ||
+            length > VIRTUAL_MODEM_FRAME_SIZE || fields.size() != (this->multiConnection ? 2U : 1U))
+            return RESULT_ERROR;
+
+        this->mode = MODE_SEND_DATA;
+        this->data.clear();
+        this->dataExpected = length;
+        this->dataLink = link;
+
+        this->replyRaw("\r\n> ");
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+CIPCLOSE=")) {
+        std::vector<std::string> fields = parameters(command.substr(12));
+        int link = this->multiConnection ? atoi(fields[0].c_str()) : 0;
+
+        if(link < 0 || link > 7 || !this->links[link].open)
+            return RESULT_ERROR;
+
+        this->links[link] = Link();
+        this->reply(this->linkPrefix(link) + "CLOSE OK");
+
+        return RESULT_SENT;
+    }
+
+    if(command == "AT+CIPSTATUS") {
+        this->executeStatus();
+        return RESULT_SENT;
+    }
+
+    if(command == "AT+SAPBR=2,1") {
+        this->reply(this->bearerOpen ?
+            "+SAPBR: 1,1,\"" + this->ipAddress + "\"" :
+            std::string("+SAPBR: 1,3,\"0.0.0.0\""));
+
+        return RESULT_OK;
+    }
+
+    if(command == "AT+SAPBR=1,1" || command == "AT+SAPBR=0,1") {
+        this->bearerOpen = command == "AT+SAPBR=1,1";
+        return RESULT_OK;
+    }
+
+    if(command == "AT+HTTPINIT") {
+        if(this->httpInitialised)
+            return RESULT_ERROR;
+
+        this->httpInitialised = true;
+        this->httpURL.clear();
+        this->httpContent.clear();
+        this->httpUserData.clear();
+        this->httpData.clear();
+
+        return RESULT_OK;
+    }
+
+    if(command == "AT+HTTPTERM") {
+        if(!this->httpInitialised)
+            return RESULT_ERROR;
+
+        this->httpInitialised = false;
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+HTTPPARA=")) {
+        std::vector<std::string> fields = parameters(command.substr(12));
+        if(!this->httpInitialised || fields.size() != 2)
+            return RESULT_ERROR;
+
+        if(fields[0] == "URL")
+            this->httpURL = fields[1];
+        else if(fields[0] == "CONTENT")
+            this->httpContent = fields[1];
+        else if(fields[0] == "USERDATA")
+            this->httpUserData = fields[1];
+        else if(fields[0] != "CID")
+            return RESULT_ERROR;
+
+        return RESULT_OK;
+    }
+
+    if(startsWith(command, "AT+HTTPDATA=")) {
+        std::vector<std::string> fields = parameters(command.substr(12));
+        size_t length = (size_t) atol(fields[0].c_str());
+
+        if(!this->httpInitialised || fields.size() != 2 || length == 0)
+            return RESULT_ERROR;
+
+        this->mode = MODE_HTTP_DATA;
+        this->data.clear();
+        this->dataExpected = length;
+
+        this->reply("DOWNLOAD");
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+HTTPACTION=")) {
+        if(!this->httpInitialised || !this->bearerOpen)
+            return RESULT_ERROR;
+
+        this->executeHTTPAction(atoi(command.c_str() + 14));
+        return RESULT_SENT;
+    }
+
+    if(startsWith(command, "AT+HTTPREAD=")) {
+        std::vector<std::string> fields = parameters(command.substr(12));
+        if(!this->httpInitialised || fields.size() != 2)
+            return RESULT_ERROR;
+
+        this->executeHTTPRead((size_t) atol(fields[0].c_str()), (size_t) atol(fields[1].c_str()));
+        return RESULT_SENT;
+    }
+
+    return RESULT_ERROR;
+}
+
+void VirtualModem::executeListSMS(const std::string& filter) {
+    std::string lines;
+
+    for(size_t i = 0; i < this->inbox.size(); i++) {
+        Message& message = this->inbox[i];
+        if(filter != "ALL" && message.status != filter)
+            continue;
+
+        if(!lines.empty())
+            lines += '\n';
+
+        lines += "+CMGL: " + std::to_string(message.index) + ",\"" + message.status + "\",\"" +
+            message.number + "\",\"\",\"" + message.timestamp + "\"\n" + message.text;
+
+        if(message.status == "REC UNREAD")
+            message.status = "REC READ";
+    }
+
+    if(!lines.empty())
+        this->reply(lines);
+}
+
+std::string VirtualModem::linkPrefix(int link) const {
+    return this->multiConnection ? std::to_string(link) + ", " : std::string();
+}
+
+void VirtualModem::executeStartConnection(const std::string& text) {
+    std::vector<std::string> fields = parameters(text);
+    int link = 0;
+
+    if(this->multiConnection) {
+        link = atoi(fields[0].c_str());
+        fields.erase(fields.begin());
+    }
+
+    if(link < 0 || link > 7 || fields.size() != 3 || fields[0] != "TCP") {
+        this->reply("ERROR");
+        return;
+    }
+
+    if(this->links[link].open) {
+        this->reply(this->linkPrefix(link) + "ALREADY CONNECT");
+        return;
+    }
+
+    this->reply("OK");
+    if(!this->server) {
+        this->reply(this->linkPrefix(link) + "CONNECT FAIL", this->connectTime);
+        return;
+    }
+
+    Link& connection = this->links[link];
+    connection.open = true;
+    connection.host = fields[1];
+    connection.port = (uint16_t) atoi(fields[2].c_str());
+    connection.received.clear();
+
+    this->connectionsOpened++;
+    this->reply(this->linkPrefix(link) + "CONNECT OK", this->connectTime);
+}
+
+void VirtualModem::executeStatus() {
+    this->reply("OK");
+
+    if(!this->multiConnection) {
+        this->reply(this->links[0].open ? "STATE: CONNECT OK" : "STATE: IP STATUS");
+        return;
+    }
+
+    std::string lines = "STATE: IP PROCESSING";
+    for(int i = 0; i < 8; i++) {
+        const Link& link = this->links[i];
+
+        lines += "\nC: " + std::to_string(i) + ",0,\"TCP\",\"" + link.host + "\",\"" +
+            (link.open ? std::to_string(link.port) : std::string()) + "\",\"" +
+            (link.open ? "CONNECTED" : "INITIAL") + "\"";
+    }
+
+    this->reply(lines);
+}
+
+void VirtualModem::handleSMSText(uint64_t time, bool cancelled) {
+    this->mode = MODE_COMMAND;
+    if(cancelled)
+        return;
+
+    if(this->echo)
+        this->schedule(time, this->data);
+
+    this->answerTime = time + this->smsTime;
+    this->answer.clear();
+
+    Fault fault;
+    bool faulty = this->takeFault("<SMS>", fault);
+
+    if(faulty && fault == FAULT_SILENCE)
+        return;
+
+    if(faulty && fault == FAULT_ERROR)
+        this->reply("+CMS ERROR: 500");
+    else {
+        SentMessage message;
+        message.number = this->smsNumber;
+        message.text = this->data;
+        message.reference = this->nextReference++;
+
+        this->sent.push_back(message);
+        this->reply("+CMGS: " + std::to_string(message.reference));
+        this->reply("OK");
+    }
+
+    this->sendAnswer(faulty ? &fault : NULL);
+}
+
+void VirtualModem::handleSendData(uint64_t time) {
+    this->mode = MODE_COMMAND;
+    this->answerTime = time + this->latency;
+    this->answer.clear();
+
+    Fault fault;
+    bool faulty = this->takeFault("<CIPSEND>", fault);
+
+    if(faulty && fault == FAULT_SILENCE)
+        return;
+
+    if(faulty && fault == FAULT_ERROR) {
+        this->reply(this->linkPrefix(this->dataLink) + "SEND FAIL");
+        this->sendAnswer(NULL);
+
+        return;
+    }
+
+    this->links[this->dataLink].received += this->data;
+    this->reply(this->linkPrefix(this->dataLink) + "SEND OK");
+    this->sendAnswer(faulty ? &fault : NULL);
+
+    this->serveLink(this->dataLink, this->answerTime);
+}
+
+void VirtualModem::handleHTTPData(uint64_t time) {
+    this->mode = MODE_COMMAND;
+    this->answerTime = time + this->latency;
+    this->answer.clear();
+
+    Fault fault;
+    bool faulty = this->takeFault("<HTTPDATA>", fault);
+
+    if(faulty && fault == FAULT_SILENCE)
+        return;
+
+    if(faulty && fault == FAULT_ERROR)
+        this->reply("ERROR");
+    else {
+        this->httpData = this->data;
+        this->reply("OK");
+    }
+
+    this->sendAnswer(faulty ? &fault : NULL);
+}
+
+void VirtualModem::serveLink(int index, uint64_t time) {
+    Link& link = this->links[index];
+
+    for(;;) {
+        size_t end = link.received.find("\r\n\r\n");
+        if(end == std::string::npos)
+            return;
+
+        HTTPRequest request;
+        request.host = link.host;
+        request.port = link.port;
+
+        size_t position = link.received.find("\r\n");
+        std::string requestLine = link.received.substr(0, position);
+        std::string version;
+
+        size_t space = requestLine.find(' ');
+        size_t second = requestLine.find(' ', space + 1);
+        request.method = requestLine.substr(0, space);
+        request.path = requestLine.substr(space + 1, second - space - 1);
+        version = requestLine.substr(second + 1);
+
+        while(position < end) {
+            size_t next = link.received.find("\r\n", position + 2);
+            std::string header = link.received.substr(position + 2, next - position - 2);
+            size_t colon = header.find(':');
+
+            if(colon != std::string::npos) {
+                size_t value = header.find_first_not_of(' ', colon + 1);
+                request.headers.push_back(std::make_pair(
+                    header.substr(0, colon),
+                    value == std::string::npos ? std::string() : header.substr(value)
+                ));
+            }
+
+            position = next;
+        }
+
+        size_t length = (size_t) atol(request.header("Content-Length").c_str());
+        if(link.received.size() < end + 4 + length)
+            return;
+
+        request.body = link.received.substr(end + 4, length);
+        link.received.erase(0, end + 4 + length);
+
+        this->requests.push_back(request);
+        HTTPReply reply = this->server(request);
+
+        if(version == "HTTP/1.0" && strcasecmp(request.header("Connection").c_str(), "keep-alive") != 0)
+            reply.close = true;
+
+        std::string bytes = this->formatReply(reply);
+        uint64_t start = time + this->serverTime;
+
+        for(size_t offset = 0; offset < bytes.size(); offset += VIRTUAL_MODEM_FRAME_SIZE) {
+            std::string frame = bytes.substr(offset, VIRTUAL_MODEM_FRAME_SIZE);
+
+            if(this->multiConnection)
+                this->schedule(start, "\r\n+RECEIVE," + std::to_string(index) + "," +
+                    std::to_string(frame.size()) + ":\r\n" + frame);
+            else this->schedule(start, frame);
+        }
+
+        if(reply.close) {
+            this->schedule(start, "\r\n" + this->linkPrefix(index) + "CLOSED\r\n", [this, index]() {
+                this->links[index] = Link();
+            });
+
+            return;
+        }
+    }
+}
+
+std::string VirtualModem::formatReply(const HTTPReply& reply) const {
+    std::string bytes = "HTTP/1.1 " + std::to_string(reply.status) +
+        (reply.status == 200 ? " OK" : reply.status == 404 ? " Not Found" : " Status") + "\r\n";
+
+    for(size_t i = 0; i < reply.headers.size(); i++)
+        bytes += reply.headers[i].first + ": " + reply.headers[i].second + "\r\n";
+
+    if(reply.chunked)
+        bytes += "Transfer-Encoding: chunked\r\n";
+    else bytes += "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+
+    if(reply.close)
+        bytes += "Connection: close\r\n";
+
+    bytes += "\r\n";
+    if(!reply.chunked)
+        return bytes + reply.body;
+
+    for(size_t offset = 0; offset < reply.body.size(); offset += 512) {
+        std::string chunk = reply.body.substr(offset, 512);
+        char size[16];
+
+        snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+        bytes += size + chunk + "\r\n";
+    }
+
+    return bytes + "0\r\n\r\n";
+}
+
+void VirtualModem::executeHTTPAction(int action) {
+    static const char* const methods[] = {"GET", "POST", "HEAD"};
+
+    if(action < 0 || action > 2) {
+        this->reply("ERROR");
+        return;
+    }
+
+    HTTPRequest request;
+    request.method = methods[action];
+    request.port = 80;
+
+    std::string url = this->httpURL;
+    if(startsWith(url, "http://"))
+        url.erase(0, 7);
+
+    size_t slash = url.find('/');
+    std::string authority = url.substr(0, slash);
+    request.path = slash == std::string::npos ? "/" : url.substr(slash);
+
+    size_t colon = authority.find(':');
+    request.host = authority.substr(0, colon);
+    if(colon != std::string::npos)
+        request.port = (uint16_t) atoi(authority.c_str() + colon + 1);
+
+    for(size_t start = 0; !this->httpUserData.empty() && start != std::string::npos;) {
+        size_t end = this->httpUserData.find("\\r\\n", start);
+        std::string header = this->httpUserData.substr(start, end == std::string::npos ? end : end - start);
+        size_t separator = header.find(':');
+
+        if(separator != std::string::npos)
+            request.headers.push_back(std::make_pair(
+                header.substr(0, separator),
+                header.substr(header.find_first_not_of(' ', separator + 1))
+            ));
+
+        start = end == std::string::npos ? end : end + 4;
+    }
+
+    if(!this->httpContent.empty())
+        request.headers.push_back(std::make_pair(std::string("Content-Type"), this->httpContent));
+
+    if(action == 1)
+        request.body = this->httpData;
+
+    this->reply("OK");
+    if(!this->server) {
+        this->reply("+HTTPACTION: " + std::to_string(action) + ",601,0", this->serverTime);
+        return;
+    }
+
+    this->requests.push_back(request);
+    this->httpReply = this->server(request);
+
+    this->reply("+HTTPACTION: " + std::to_string(action) + "," + std::to_string(this->httpReply.status) +
+        "," + std::to_string(this->httpReply.body.size()), this->serverTime);
+}
+
+void VirtualModem::executeHTTPRead(size_t offset, size_t size) {
+    std::string chunk = offset < this->httpReply.body.size() ?
+        this->httpReply.body.substr(offset, size) : std::string();
+
+    this->replyRaw("\r\n+HTTPREAD: " + std::to_string(chunk.size()) + "\r\n" + chunk + "\r\nOK\r\n");
+}
@@ -0,0 +1,376 @@
+/*
+ * This file is part of the SIM900 Arduino Shield library.
+ * Copyright (c) 2023 Nathanne Isip
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef VIRTUAL_MODEM_H
+#define VIRTUAL_MODEM_H
+
+#include <Arduino.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ *
+ * @class VirtualModem
+ * @brief A simulated SIM900 module behind a Stream, for testing the library on a host computer.
+ *
+ * The modem answers the AT commands used by the library from its own state (phonebook, message storage, TCP links,
+ * HTTP service), running on the virtual clock of the Arduino shim. Bytes travel at the configured baud rate in both
+ * directions, and each command is answered after a configurable processing latency. Tests can script commands with
+ * their own handlers, inject unsolicited result codes and make commands fail in several ways.
+ *
+ */
+class VirtualModem : public Stream, public ArduinoShim::Clocked {
+public:
+    /// The ways a command can be made to fail.
+    enum Fault {
+        /// Answer with ERROR instead of running the command.
+        FAULT_ERROR,
+
+        /// Do not answer at all, so the command times out.
+        FAULT_SILENCE,
+
+        /// Corrupt the letters of the answer, so no result code is recognised.
+        FAULT_GARBLE,
+
+        /// Send only the first half of the answer.
+        FAULT_TRUNCATE
+    };
+
+    /// A handler scripting the answer to a command through reply() and the other answer functions.
+    typedef std::function<void(VirtualModem& modem, const std::string& command)> Handler;
+
+    /// An entry of the SIM phonebook.
+    struct Entry {
+        std::string number;
+        int type;
+        std::string name;
+    };
+
+    /// A message of the message storage.
+    struct Message {
+        int index;
+        std::string status;
+        std::string number;
+        std::string timestamp;
+        std::string text;
+    };
+
+    /// A message sent through AT+CMGS.
+    struct SentMessage {
+        std::string number;
+        std::string text;
+        int reference;
+    };
+
+    /// An HTTP request received by the simulated server, through a TCP link or the built-in HTTP engine.
+    struct HTTPRequest {
+        std::string method;
+        std::string host;
+        uint16_t port;
+        std::string path;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+
+        /// Get the value of a header, or an empty string if it is missing.
+        std::string header(const std::string& key) const;
+    };
+
+    /// The response of the simulated server to an HTTP request.
+    struct HTTPReply {
+        int status = 200;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+
+        /// Send the body with chunked transfer encoding instead of a Content-Length header.
+        bool chunked = false;
+
+        /// Close the TCP link after the response.
+        bool close = false;
+    };
+
+    /// The simulated HTTP server answering the requests of both HTTP engines.
+    typedef std::function<HTTPReply(const HTTPRequest& request)> Server;
+
+    explicit VirtualModem(uint32_t baud = 0);
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t size);
+    void flush();
+
+    using Print::write;
+
+    uint64_t nextEvent();
+
+    /// Set the baud rate of the modem, 0 for no throttling. The host port is assumed to be opened at the same rate.
+    void setBaudRate(uint32_t baud);
+
+    /// Set the baud rate the host port is opened at. While it differs from the rate of the modem, neither understands the other.
+    void setHostBaudRate(uint32_t baud);
+
+    /// Get the baud rate of the modem.
+    uint32_t baudRate() const;
+
+    /// Set the time in microseconds the modem takes to start answering any command.
+    void setLatency(uint32_t micros);
+
+    /// Set the time in microseconds the modem takes to start answering the commands with the given prefix.
+    void setLatency(const std::string& prefix, uint32_t micros);
+
+    /// Answer the commands starting with the given prefix with a handler, overriding the built-in behaviour.
+    void on(const std::string& prefix, Handler handler);
+
+    /// Answer the commands starting with the given prefix with fixed lines, separated by '\n'.
+    void on(const std::string& prefix, const std::string& lines);
+
+    /// Make the next count commands starting with the given prefix fail. Data written after a prompt is matched as
+    /// "<SMS>", "<CIPSEND>" or "<HTTPDATA>".
+    void fail(const std::string& prefix, Fault fault, unsigned count = 1);
+
+    /// Answer the command being handled with lines separated by '\n', after the given delay in microseconds.
+    void reply(const std::string& lines, uint32_t delay = 0);
+
+    /// Answer the command being handled with raw bytes, after the given delay in microseconds.
+    void replyRaw(const std::string& bytes, uint32_t delay = 0);
+
+    /// Run the built-in behaviour for the command being handled, e.g., from a handler which only adds a delay.
+    void runDefault(const std::string& command);
+
+    /// Send an unsolicited result code after the given delay in microseconds.
+    void injectURC(const std::string& line, uint32_t delay = 0);
+
+    /// Send raw bytes after the given delay in microseconds.
+    void inject(const std::string& bytes, uint32_t delay = 0);
+
+    /// Switch the modem off, so it ignores everything until boot() is called.
+    void powerOff();
+
+    /// Switch the modem on, reporting the boot stages with unsolicited result codes over the given time in milliseconds.
+    void boot(uint32_t milliseconds);
+
+    /// Get the command lines received so far.
+    const std::vector<std::string>& commands() const;
+
+    /// Get the number of command lines received so far which start with the given prefix.
+    unsigned count(const std::string& prefix) const;
+
+    /// Forget the command lines received so far.
+    void clearCommands();
+
+    /// Get the number of bytes written by the host.
+    uint64_t bytesFromHost() const;
+
+    /// Get the number of bytes sent to the host.
+    uint64_t bytesToHost() const;
+
+    /// The command echo mode (ATE).
+    bool echo = true;
+
+    /// The message format (AT+CMGF).
+    int messageFormat = 0;
+
+    /// The signal quality reported by AT+CSQ.
+    int rssi = 20;
+    int bitErrorRate = 0;
+
+    /// The operator name reported by AT+COPS?.
+    std::string operatorName = "Virtual Mobile";
+
+    /// The own number reported by AT+CNUM.
+    std::string ownNumber = "+15550000000";
+
+    /// The real-time clock (AT+CCLK), as "yy/MM/dd,hh:mm:ss+zz".
+    std::string clock = "24/01/02,03:04:05+32";
+
+    /// The SIM phonebook (AT+CPBR, AT+CPBW), by index.
+    std::map<int, Entry> phonebook;
+
+    /// The number of entries the SIM phonebook can hold.
+    int phonebookSize = 250;
+
+    /// The time in microseconds the modem takes for each entry of a phonebook range read.
+    uint32_t phonebookEntryTime = 0;
+
+    /// The message storage (AT+CMGL, AT+CMGDA).
+    std::vector<Message> inbox;
+
+    /// The messages sent through AT+CMGS.
+    std::vector<SentMessage> sent;
+
+    /// The message reference of the next message sent.
+    int nextReference = 1;
+
+    /// The time in microseconds the network takes to accept a message.
+    uint32_t smsTime = 0;
+
+    /// The result of dialling (ATD, ATDL) and answering (ATA).
+    std::string dialResult = "OK";
+
+    /// The IP address of the GPRS connection (AT+CIFSR, AT+SAPBR).
+    std::string ipAddress = "10.0.0.2";
+
+    /// The time in microseconds a TCP connection takes to open.
+    uint32_t connectTime = 0;
+
+    /// The time in microseconds the server takes to answer a request.
+    uint32_t serverTime = 0;
+
+    /// The HTTP server reached through TCP links and the built-in HTTP engine. Connections fail while there is none.
+    Server server;
+
+    /// The HTTP requests received by the server.
+    std::vector<HTTPRequest> requests;
+
+    /// The number of TCP connections opened.
+    unsigned connectionsOpened = 0;
+
+private:
+    /// Bytes or an action scheduled at a virtual time.
+    struct Event {
+        std::string bytes;
+        std::function<void()> action;
+    };
+
+    /// A TCP link (AT+CIPSTART).
+    struct Link {
+        bool open = false;
+        std::string host;
+        uint16_t port = 0;
+        std::string received;
+    };
+
+    /// The outcomes of a built-in command: the final result to add, or none if the command sent its own.
+    enum Result {
+        RESULT_ERROR,
+        RESULT_OK,
+        RESULT_SENT
+    };
+
+    /// What the bytes written by the host are taken as.
+    enum Mode {
+        MODE_COMMAND,
+        MODE_SMS_TEXT,
+        MODE_SEND_DATA,
+        MODE_HTTP_DATA
+    };
+
+    struct Script {
+        std::string prefix;
+        Handler handler;
+    };
+
+    struct Failure {
+        std::string prefix;
+        Fault fault;
+        unsigned count;
+    };
+
+    uint32_t baud;
+    uint32_t hostBaud;
+    uint32_t latency = 0;
+    std::vector<std::pair<std::string, uint32_t>> latencies;
+
+    std::vector<Script> scripts;
+    std::vector<Failure> failures;
+
+    std::multimap<uint64_t, Event> events;
+    std::deque<std::pair<uint64_t, uint8_t>> wire;
+    size_t readyCount = 0;
+    uint64_t wireFree = 0;
+    uint64_t hostFree = 0;
+
+    bool powered = true;
+    uint64_t readyAt = 0;
+
+    Mode mode = MODE_COMMAND;
+    std::string line;
+    std::string data;
+    size_t dataExpected = 0;
+    int dataLink = 0;
+    std::string smsNumber;
+
+    /// Whether the last byte ended a command line, so a line feed after it is skipped even if a prompt was opened.
+    bool commandEnded = false;
+
+    std::vector<std::string> received;
+    uint64_t fromHost = 0;
+    uint64_t toHost = 0;
+
+    /// The time the answer of the command being handled starts, and the answer collected so far.
+    uint64_t answerTime = 0;
+    std::vector<std::pair<uint64_t, std::string>> answer;
+
+    /// The delay in microseconds of the final result of the command being handled.
+    uint32_t resultDelay = 0;
+
+    /// The baud rate the modem switches to once the answer of the command being handled is sent, or 0.
+    uint32_t pendingBaud = 0;
+
+    bool multiConnection = false;
+    Link links[8];
+
+    bool bearerOpen = false;
+    bool httpInitialised = false;
+    std::string httpURL;
+    std::string httpContent;
+    std::string httpUserData;
+    std::string httpData;
+    HTTPReply httpReply;
+
+    uint64_t byteTime() const;
+    bool understood() const;
+    void schedule(uint64_t time, const std::string& bytes, std::function<void()> action = nullptr);
+    void pump();
+
+    void receiveByte(uint8_t data, uint64_t time);
+    void handleCommand(const std::string& command, uint64_t time);
+    void handleSMSText(uint64_t time, bool cancelled);
+    void handleSendData(uint64_t time);
+    void handleHTTPData(uint64_t time);
+    bool takeFault(const std::string& command, Fault& fault);
+    void sendAnswer(const Fault* fault);
+
+    int execute(const std::string& command);
+    int executeBasic(const std::string& command);
+    void executeListSMS(const std::string& filter);
+    void executeStartConnection(const std::string& parameters);
+    void executeStatus();
+    void executeHTTPAction(int action);
+    void executeHTTPRead(size_t offset, size_t size);
+
+    void serveLink(int link, uint64_t time);
+    std::string formatReply(const HTTPReply& reply) const;
+    std::string linkPrefix(int link) const;
+
+    static bool startsWith(const std::string& text, const std::string& prefix);
+    static std::vector<std::string> parameters(const std::string& text);
+};
+
+#endif